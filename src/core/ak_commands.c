@@ -0,0 +1,130 @@
+#include "ak_commands.h"
+
+// Slot turns follow the bounded queue of D. Vyukov: a producer claims the
+// tail index with a compare-and-swap, fills the slot, then publishes it by
+// advancing the slot's turn, so producers never wait on each other or on the
+// consumer.
+#if defined(__GCC_ATOMIC_INT_LOCK_FREE) && __GCC_ATOMIC_INT_LOCK_FREE == 2 &&  \
+    __SIZEOF_INT__ == 4
+#define AK_LOAD_RELAXED(p) __atomic_load_n((p), __ATOMIC_RELAXED)
+#define AK_LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define AK_STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define AK_CAS(p, expected, desired)                                           \
+  __atomic_compare_exchange_n((p), (expected), (desired), 1, __ATOMIC_RELAXED, \
+                              __ATOMIC_RELAXED)
+#else
+// No lock-free atomics (the consoles): single-threaded use only
+#define AK_LOAD_RELAXED(p) (*(p))
+#define AK_LOAD_ACQUIRE(p) (*(p))
+#define AK_STORE_RELEASE(p, v) (*(p) = (v))
+#define AK_CAS(p, expected, desired) (*(p) = (desired), 1)
+#endif
+
+#define AK_COMMAND_MASK (AK_MAX_COMMANDS - 1)
+
+void ak_commands_init(ak_command_queue_t *queue) {
+  for (int i = 0; i < AK_MAX_COMMANDS; i++)
+    queue->slots[i].seq = (uint32_t)i;
+  queue->tail = 0;
+  queue->head = 0;
+  queue->dropped = 0;
+}
+
+int ak_commands_push(ak_command_queue_t *queue, const ak_command_t *command) {
+  uint32_t pos = AK_LOAD_RELAXED(&queue->tail);
+  ak_command_slot_t *slot;
+  for (;;) {
+    slot = &queue->slots[pos & AK_COMMAND_MASK];
+    int32_t turn = (int32_t)(AK_LOAD_ACQUIRE(&slot->seq) - pos);
+    if (turn == 0) {
+      if (AK_CAS(&queue->tail, &pos, pos + 1))
+        break;
+    } else if (turn < 0) {
+      return 0; // Still holds a command from one lap ago: full
+    } else {
+      pos = AK_LOAD_RELAXED(&queue->tail); // Another producer took it
+    }
+  }
+  slot->command = *command;
+  AK_STORE_RELEASE(&slot->seq, pos + 1);
+  return 1;
+}
+
+static int Before(const ak_command_t *a, const ak_command_t *b) {
+  if (a->source != b->source)
+    return a->source < b->source;
+  return (int32_t)(a->seq - b->seq) < 0;
+}
+
+// Returns 0 if the command was dropped
+static int Apply(ak_world_t *world, const ak_command_t *c) {
+  if (c->type == AK_COMMAND_ADD_BODY) {
+    if (!ak_body_valid(c->shape, c->value))
+      return 0;
+    ak_body_t *body = ak_world_add_body(world, c->shape, c->position.x,
+                                        c->position.y, c->value);
+    if (!body)
+      return 0;
+    body->id = c->id;
+    body->velocity = c->vector;
+    return 1;
+  }
+
+  ak_body_t *body = ak_world_find_body(world, c->id);
+  if (!body)
+    return 0;
+
+  switch (c->type) {
+  case AK_COMMAND_ADD_BODY: // Handled above
+    break;
+  case AK_COMMAND_REMOVE_BODY:
+    ak_world_remove_body(world, body);
+    break;
+  case AK_COMMAND_APPLY_FORCE:
+    body->force = ak_vec2_add(body->force, c->vector);
+    break;
+  case AK_COMMAND_SET_VELOCITY:
+    body->velocity = c->vector;
+    break;
+  case AK_COMMAND_ADD_TETHER: {
+    ak_body_t *other = ak_world_find_body(world, c->other_id);
+    int tethers = world->tether_count;
+    if (!other || other == body)
+      return 0;
+    ak_world_add_tether(world, body, other, c->value);
+    return world->tether_count > tethers;
+  }
+  }
+  return 1;
+}
+
+int ak_commands_apply(ak_command_queue_t *queue, ak_world_t *world) {
+  // Pop every published command
+  int count = 0;
+  for (;;) {
+    ak_command_slot_t *slot = &queue->slots[queue->head & AK_COMMAND_MASK];
+    if (AK_LOAD_ACQUIRE(&slot->seq) != queue->head + 1)
+      break;
+    queue->batch[count++] = slot->command;
+    AK_STORE_RELEASE(&slot->seq, queue->head + AK_MAX_COMMANDS);
+    queue->head++;
+    if (count == AK_MAX_COMMANDS)
+      break;
+  }
+
+  // Insertion sort into (source, seq) order; batches are small
+  for (int i = 1; i < count; i++) {
+    ak_command_t c = queue->batch[i];
+    int j = i;
+    while (j > 0 && Before(&c, &queue->batch[j - 1])) {
+      queue->batch[j] = queue->batch[j - 1];
+      j--;
+    }
+    queue->batch[j] = c;
+  }
+
+  for (int i = 0; i < count; i++)
+    if (!Apply(world, &queue->batch[i]))
+      queue->dropped++;
+  return count;
+}
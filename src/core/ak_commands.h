@@ -0,0 +1,79 @@
+#ifndef AK_COMMANDS_H
+#define AK_COMMANDS_H
+
+#include "ak_physics.h"
+
+/*
+ * Bounded multi-producer, single-consumer command queue. Other threads
+ * (network, AI) push commands without locks while the physics thread is
+ * stepping; a world with the queue attached (ak_world_set_commands) drains it
+ * at the start of each step. Commands name bodies by ak_body_t::id, since
+ * indices move when bodies are removed.
+ *
+ * Each drained batch is applied in (source, seq) order, not arrival order,
+ * so the result does not depend on how the producer threads interleaved:
+ * give every producer its own source number and let it count seq up.
+ *
+ * Lock-free where the compiler provides lock-free atomics (GCC/Clang on PC
+ * and ARM); elsewhere the queue is only safe from a single thread.
+ */
+
+// Must be a power of two
+#ifndef AK_MAX_COMMANDS
+#define AK_MAX_COMMANDS 64
+#endif
+
+typedef enum {
+  AK_COMMAND_ADD_BODY,     // shape, position, vector (velocity), value (mass)
+  AK_COMMAND_REMOVE_BODY,  // Also removes its tethers and frees rope ends
+  AK_COMMAND_APPLY_FORCE,  // vector is added to the body's force
+  AK_COMMAND_SET_VELOCITY, // vector
+  AK_COMMAND_ADD_TETHER    // Between id and other_id, value (max length)
+} ak_command_type_t;
+
+typedef struct {
+  ak_command_type_t type;
+  uint16_t source; // Producer number
+  uint32_t seq;    // Per-producer sequence number
+  int id;          // Body acted on; the new body's id for ADD_BODY
+  int other_id;
+  ak_shape_t shape;
+  ak_vec2_t position;
+  ak_vec2_t vector;
+  ak_fixed_t value;
+} ak_command_t;
+
+typedef struct {
+  ak_command_t command;
+  uint32_t seq; // Slot turn: free for push at index, ready for pop at index + 1
+} ak_command_slot_t;
+
+typedef struct ak_command_queue {
+  ak_command_slot_t slots[AK_MAX_COMMANDS];
+  uint32_t tail; // Next push index, shared by the producers
+  uint32_t head; // Next pop index, consumer only
+  ak_command_t batch[AK_MAX_COMMANDS]; // Consumer scratch for sorting
+  uint32_t dropped; // Commands that could not be applied; consumer only
+} ak_command_queue_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void ak_commands_init(ak_command_queue_t *queue);
+// Any thread. Returns 0 if the queue is full.
+int ak_commands_push(ak_command_queue_t *queue, const ak_command_t *command);
+/**
+ * Pop everything pushed so far and apply it to the world. Called by the step;
+ * only call it directly from the thread that steps the world. Commands for
+ * unknown ids, bodies that fail ak_body_valid, and commands that do not fit
+ * the world are dropped and counted in queue->dropped. Returns the number of
+ * commands popped.
+ */
+int ak_commands_apply(ak_command_queue_t *queue, ak_world_t *world);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_COMMANDS_H
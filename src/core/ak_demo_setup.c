@@ -81,4 +81,27 @@ void ak_demo_create_standard_scene(ak_world_t *world) {
 
   ak_world_add_tether(world, b1, b2, AK_FIXED_MUL(AK_INT_TO_FIXED(40), scale));
   ak_world_add_tether(world, b2, b3, AK_FIXED_MUL(AK_INT_TO_FIXED(40), scale));
+
+  // 6. Hanging rope with a weight (Top Left)
+  ak_body_t *hook = ak_world_add_body(
+      world,
+      (ak_shape_t){.type = AK_SHAPE_CIRCLE,
+                   .bounds.circle = {AK_FIXED_MUL(AK_INT_TO_FIXED(2), scale)}},
+      offset_x + AK_FIXED_MUL(AK_INT_TO_FIXED(30), scale),
+      AK_FIXED_MUL(AK_INT_TO_FIXED(20), scale), 0); // Static
+
+  ak_body_t *weight = ak_world_add_body(
+      world,
+      (ak_shape_t){.type = AK_SHAPE_CIRCLE,
+                   .bounds.circle = {AK_FIXED_MUL(AK_INT_TO_FIXED(6), scale)}},
+      offset_x + AK_FIXED_MUL(AK_INT_TO_FIXED(90), scale),
+      AK_FIXED_MUL(AK_INT_TO_FIXED(20), scale), AK_INT_TO_FIXED(1));
+
+  ak_rope_t *rope =
+      ak_world_add_rope(world, hook->position, weight->position, 10,
+                        AK_INT_TO_FIXED(1) / 4);
+  if (rope) {
+    ak_rope_attach(world, rope, 0, hook);
+    ak_rope_attach(world, rope, 1, weight);
+  }
 }
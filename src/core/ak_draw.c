@@ -0,0 +1,202 @@
+#include "ak_draw.h"
+
+// World coordinate to pixel. 32-bit so bodies far outside the viewport are
+// culled before anything is narrowed to 16 bits.
+static int32_t ToScreen(ak_fixed_t v, ak_fixed_t origin, ak_fixed_t scale) {
+  v = AK_FIXED_SUB(v, origin);
+  if (scale != AK_FIXED_ONE)
+    v = AK_FIXED_MUL(v, scale);
+  return (int32_t)(v >> AK_FIXED_SHIFT);
+}
+
+static int16_t Clamp16(int32_t v) {
+  return (int16_t)(v < -32768 ? -32768 : v > 32767 ? 32767 : v);
+}
+
+// Whether the pixel box [x0, x1] x [y0, y1] touches the viewport
+static int Visible(const ak_draw_viewport_t *vp, int32_t x0, int32_t y0,
+                   int32_t x1, int32_t y1) {
+  return x1 >= 0 && y1 >= 0 && x0 < vp->width && y0 < vp->height;
+}
+
+static ak_draw_prim_t *Next(ak_draw_list_t *out, int *used) {
+  if (*used >= AK_MAX_DRAW_PRIMS) {
+    out->dropped++;
+    return 0;
+  }
+  return &out->prims[(*used)++];
+}
+
+static void AddLine(ak_draw_list_t *out, int *used,
+                    const ak_draw_viewport_t *vp, ak_vec2_t scale, ak_vec2_t a,
+                    ak_vec2_t b, uint8_t flags) {
+  int32_t x1 = ToScreen(a.x, vp->origin.x, scale.x);
+  int32_t y1 = ToScreen(a.y, vp->origin.y, scale.y);
+  int32_t x2 = ToScreen(b.x, vp->origin.x, scale.x);
+  int32_t y2 = ToScreen(b.y, vp->origin.y, scale.y);
+  if (!Visible(vp, x1 < x2 ? x1 : x2, y1 < y2 ? y1 : y2, x1 < x2 ? x2 : x1,
+               y1 < y2 ? y2 : y1))
+    return;
+  ak_draw_prim_t *p = Next(out, used);
+  if (!p)
+    return;
+  p->line.x1 = Clamp16(x1);
+  p->line.y1 = Clamp16(y1);
+  p->line.x2 = Clamp16(x2);
+  p->line.y2 = Clamp16(y2);
+  p->line.flags = flags;
+  out->line_count++;
+}
+
+static void AddCircle(ak_draw_list_t *out, int *used,
+                      const ak_draw_viewport_t *vp, ak_vec2_t scale,
+                      const ak_body_t *b) {
+  int32_t x = ToScreen(b->position.x, vp->origin.x, scale.x);
+  int32_t y = ToScreen(b->position.y, vp->origin.y, scale.y);
+  int32_t r = ToScreen(b->shape.bounds.circle.radius, 0, scale.x);
+  if (!Visible(vp, x - r, y - r, x + r, y + r))
+    return;
+  ak_draw_prim_t *p = Next(out, used);
+  if (!p)
+    return;
+  p->circle.x = Clamp16(x);
+  p->circle.y = Clamp16(y);
+  p->circle.r = Clamp16(r);
+  p->circle.flags = b->is_static ? AK_DRAW_STATIC : 0;
+  out->circle_count++;
+}
+
+// A box given relative to the viewport origin, in world units
+static void AddRect(ak_draw_list_t *out, int *used,
+                    const ak_draw_viewport_t *vp, ak_vec2_t scale,
+                    ak_fixed_t left, ak_fixed_t top, ak_fixed_t right,
+                    ak_fixed_t bottom, uint8_t flags) {
+  int32_t x0 = ToScreen(left, 0, scale.x);
+  int32_t y0 = ToScreen(top, 0, scale.y);
+  int32_t x1 = ToScreen(right, 0, scale.x);
+  int32_t y1 = ToScreen(bottom, 0, scale.y);
+  if (!Visible(vp, x0, y0, x1, y1))
+    return;
+  ak_draw_prim_t *p = Next(out, used);
+  if (!p)
+    return;
+  // Clip to a pixel outside each edge so outlines stay correct
+  if (x0 < -1)
+    x0 = -1;
+  if (y0 < -1)
+    y0 = -1;
+  if (x1 > vp->width)
+    x1 = vp->width;
+  if (y1 > vp->height)
+    y1 = vp->height;
+  p->rect.x = (int16_t)x0;
+  p->rect.y = (int16_t)y0;
+  p->rect.w = (int16_t)(x1 - x0);
+  p->rect.h = (int16_t)(y1 - y0);
+  p->rect.flags = flags;
+  out->rect_count++;
+}
+
+static void AddBodyRect(ak_draw_list_t *out, int *used,
+                        const ak_draw_viewport_t *vp, ak_vec2_t scale,
+                        const ak_body_t *b) {
+  ak_fixed_t px = AK_FIXED_SUB(b->position.x, vp->origin.x);
+  ak_fixed_t py = AK_FIXED_SUB(b->position.y, vp->origin.y);
+  ak_fixed_t w = b->shape.bounds.aabb.width;
+  ak_fixed_t h = b->shape.bounds.aabb.height;
+  AddRect(out, used, vp, scale, AK_FIXED_SUB(px, w), AK_FIXED_SUB(py, h),
+          AK_FIXED_ADD(px, w), AK_FIXED_ADD(py, h),
+          b->is_static ? AK_DRAW_STATIC : 0);
+}
+
+// The tile index (floored) of offset d from the map origin, clamped to
+// [0, count)
+static int32_t TileIndex(const ak_tilemap_t *map, ak_fixed_t d, int32_t first,
+                         int count) {
+  int32_t t = AK_FIXED_TO_INT(AK_FIXED_MUL(d, map->inv_tile_size)) + first;
+  return t < 0 ? 0 : t >= count ? count - 1 : t;
+}
+
+// Solid tiles in view, one rect per horizontal run so a floor or a wall row
+// is a single primitive
+static void AddTiles(ak_draw_list_t *out, int *used,
+                     const ak_draw_viewport_t *vp, ak_vec2_t scale,
+                     const ak_tilemap_t *map) {
+  ak_fixed_t view_w = AK_INT_TO_FIXED(vp->width);
+  ak_fixed_t view_h = AK_INT_TO_FIXED(vp->height);
+  if (scale.x != AK_FIXED_ONE)
+    view_w = AK_FIXED_DIV(view_w, scale.x);
+  if (scale.y != AK_FIXED_ONE)
+    view_h = AK_FIXED_DIV(view_h, scale.y);
+  // The viewport's top-left relative to the map origin
+  ak_fixed_t dx = AK_FIXED_SUB(vp->origin.x, map->origin.x);
+  ak_fixed_t dy = AK_FIXED_SUB(vp->origin.y, map->origin.y);
+  int32_t tx0 = TileIndex(map, dx, map->origin_tx, map->width);
+  int32_t tx1 = TileIndex(map, dx + view_w, map->origin_tx, map->width);
+  int32_t ty0 = TileIndex(map, dy, map->origin_ty, map->height);
+  int32_t ty1 = TileIndex(map, dy + view_h, map->origin_ty, map->height);
+  ak_fixed_t s = map->tile_size;
+
+  for (int32_t ty = ty0; ty <= ty1; ty++) {
+    const uint8_t *row = map->tiles + ty * map->width;
+    ak_fixed_t top = s * (ty - map->origin_ty) - dy;
+    int32_t tx = tx0;
+    while (tx <= tx1) {
+      if (!row[tx]) {
+        tx++;
+        continue;
+      }
+      int32_t start = tx;
+      while (tx <= tx1 && row[tx])
+        tx++;
+      ak_fixed_t left = s * (start - map->origin_tx) - dx;
+      AddRect(out, used, vp, scale, left, top, left + s * (tx - start),
+              top + s, AK_DRAW_STATIC | AK_DRAW_TILE);
+    }
+  }
+}
+
+int ak_world_build_draw_list(const ak_world_t *world,
+                             ak_draw_viewport_t viewport, ak_vec2_t scale,
+                             ak_draw_list_t *out) {
+  const ak_draw_viewport_t *vp = &viewport;
+  int used = 0;
+  out->circle_count = out->rect_count = out->line_count = 0;
+  out->dropped = 0;
+
+  const ak_static_world_t *sw = world->statics;
+  int static_count = sw ? sw->body_count : 0;
+
+  // One pass per type keeps each group contiguous without a sort
+  for (int i = 0; i < world->body_count; i++)
+    if (world->bodies[i].shape.type == AK_SHAPE_CIRCLE)
+      AddCircle(out, &used, vp, scale, &world->bodies[i]);
+  for (int i = 0; i < static_count; i++)
+    if (sw->bodies[i].shape.type == AK_SHAPE_CIRCLE)
+      AddCircle(out, &used, vp, scale, &sw->bodies[i]);
+
+  for (int i = 0; i < world->body_count; i++)
+    if (world->bodies[i].shape.type == AK_SHAPE_AABB)
+      AddBodyRect(out, &used, vp, scale, &world->bodies[i]);
+  for (int i = 0; i < static_count; i++)
+    if (sw->bodies[i].shape.type == AK_SHAPE_AABB)
+      AddBodyRect(out, &used, vp, scale, &sw->bodies[i]);
+  if (world->tilemap.tiles)
+    AddTiles(out, &used, vp, scale, &world->tilemap);
+
+  for (int i = 0; i < world->tether_count; i++) {
+    const ak_tether_t *t = &world->tethers[i];
+    AddLine(out, &used, vp, scale, world->bodies[t->a].position,
+            world->bodies[t->b].position, 0);
+  }
+
+  for (int i = 0; i < world->rope_count; i++) {
+    const ak_rope_t *r = &world->ropes[i];
+    const ak_rope_node_t *n = &world->rope_nodes[r->first_node];
+    for (int k = 0; k + 1 < r->node_count; k++)
+      AddLine(out, &used, vp, scale, n[k].position, n[k + 1].position,
+              AK_DRAW_ROPE);
+  }
+
+  return used;
+}
@@ -0,0 +1,82 @@
+#ifndef AK_DRAW_H
+#define AK_DRAW_H
+
+#include "ak_physics.h"
+
+/*
+ * Screen-space draw lists. ak_world_build_draw_list converts the world's
+ * bodies, its shared statics and tilemap, tethers and rope segments to
+ * integer primitives once per frame, drops the ones outside the viewport and
+ * groups the rest by type, so a renderer walks three short runs of the array
+ * instead of switching on shapes and converting fixed point per body.
+ */
+
+// Primitive capacity of one list; primitives past it (e.g. tile runs of a
+// very busy tilemap) are counted in dropped
+#ifndef AK_MAX_DRAW_PRIMS
+#define AK_MAX_DRAW_PRIMS                                                      \
+  (AK_MAX_BODIES + AK_MAX_STATIC_BODIES + AK_MAX_TETHERS + AK_MAX_ROPE_NODES)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Primitive flags
+#define AK_DRAW_STATIC 1 // Static body, shared static body or tiles
+#define AK_DRAW_ROPE 2   // Line is a rope segment rather than a tether
+#define AK_DRAW_TILE 4   // Rect is a horizontal run of solid tiles
+
+typedef struct {
+  int16_t x, y, r; // Center and radius
+  uint8_t flags;
+} ak_draw_circle_t;
+
+typedef struct {
+  int16_t x, y, w, h; // Top-left and size, as drawRect takes them
+  uint8_t flags;
+} ak_draw_rect_t;
+
+typedef struct {
+  int16_t x1, y1, x2, y2;
+  uint8_t flags;
+} ak_draw_line_t;
+
+typedef union {
+  ak_draw_circle_t circle;
+  ak_draw_rect_t rect;
+  ak_draw_line_t line;
+} ak_draw_prim_t;
+
+typedef struct {
+  ak_vec2_t origin;      // World position drawn at pixel (0, 0)
+  int16_t width, height; // In pixels
+} ak_draw_viewport_t;
+
+typedef struct {
+  // circle_count circles, then rect_count rects, then line_count lines
+  ak_draw_prim_t prims[AK_MAX_DRAW_PRIMS];
+  int circle_count;
+  int rect_count;
+  int line_count;
+  int dropped; // Visible primitives that did not fit
+} ak_draw_list_t;
+
+/**
+ * Fill out with the primitives visible in viewport. scale is pixels per world
+ * unit on each axis (AK_FIXED_ONE for 1:1, which skips the multiplies);
+ * circle radii use the x scale. Rects are clipped to one pixel outside the
+ * viewport, so their off-screen edges stay off-screen. Bodies of an attached
+ * ak_static_world_t come after the world's own, flagged AK_DRAW_STATIC, then
+ * the tilemap's solid tiles in view as one AK_DRAW_STATIC | AK_DRAW_TILE rect
+ * per run along a row. Returns the number of primitives written.
+ */
+int ak_world_build_draw_list(const ak_world_t *world,
+                             ak_draw_viewport_t viewport, ak_vec2_t scale,
+                             ak_draw_list_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_DRAW_H
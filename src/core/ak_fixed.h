@@ -22,13 +22,88 @@ typedef int32_t ak_fixed_t;
 
 // Multiplication: (a * b) >> 16
 // We cast to int64_t to prevent overflow before shifting
-#define AK_FIXED_MUL(a, b)                                                     \
+#define AK_FIXED_MUL_64(a, b)                                                  \
   ((ak_fixed_t)(((int64_t)(a) * (b)) >> AK_FIXED_SHIFT))
 
 // Division: (a << 16) / b
-#define AK_FIXED_DIV(a, b)                                                     \
+#define AK_FIXED_DIV_64(a, b)                                                  \
   ((ak_fixed_t)(((int64_t)(a) << AK_FIXED_SHIFT) / (b)))
 
+// 32-bit backend (-DAK_MATH_32), for CPUs where the 64-bit multiply and
+// divide above are library calls. Results are bit-identical to the 64-bit
+// macros for every input (division by zero aside); src/tools/ak_math_check.c
+// verifies this.
+#if defined(__cplusplus) && __cplusplus >= 201402L
+#define AK_MATH_CONSTEXPR constexpr
+#else
+#define AK_MATH_CONSTEXPR
+#endif
+
+// With a = ah * 2^16 + al and b = bh * 2^16 + bl (ah, bh signed, al, bl
+// unsigned 16-bit), (a * b) >> 16 is exactly
+// (ah * bh << 16) + ah * bl + al * bh + (al * bl >> 16) modulo 2^32.
+// MULS.W and MULU.W on the 68000 take operands of one signedness, so the
+// mixed products read the low half as signed, which is 2^16 less when its
+// top bit is set, and add that back: ah * bl = ah * (int16_t)bl + (ah << 16)
+// if bl >= 2^15. Each product is then a 16x16->32 multiply of 16-bit casts,
+// the form GCC emits as one MULS.W or MULU.W instead of calling __mulsi3.
+static inline AK_MATH_CONSTEXPR ak_fixed_t ak_fixed_mul32(ak_fixed_t a,
+                                                          ak_fixed_t b) {
+  int16_t ah = (int16_t)(a >> AK_FIXED_SHIFT);
+  int16_t bh = (int16_t)(b >> AK_FIXED_SHIFT);
+  uint16_t al = (uint16_t)a;
+  uint16_t bl = (uint16_t)b;
+  uint32_t r = (uint32_t)((int32_t)ah * bh) << AK_FIXED_SHIFT;
+  r += (uint32_t)((int32_t)ah * (int16_t)bl);
+  if (bl & 0x8000u)
+    r += (uint32_t)(int32_t)ah << AK_FIXED_SHIFT;
+  r += (uint32_t)((int32_t)(int16_t)al * bh);
+  if (al & 0x8000u)
+    r += (uint32_t)(int32_t)bh << AK_FIXED_SHIFT;
+  r += ((uint32_t)al * bl) >> AK_FIXED_SHIFT;
+  return (ak_fixed_t)r;
+}
+
+// Divides the magnitudes: a 32-bit divide for the integer part, then 16
+// shift-subtract steps on the remainder for the fraction. The remainder stays
+// below |b| <= 2^31, so doubling it never overflows.
+static inline AK_MATH_CONSTEXPR ak_fixed_t ak_fixed_div32(ak_fixed_t a,
+                                                          ak_fixed_t b) {
+  uint32_t ua = a < 0 ? 0u - (uint32_t)a : (uint32_t)a;
+  uint32_t ub = b < 0 ? 0u - (uint32_t)b : (uint32_t)b;
+  uint32_t q = ua / ub;
+  uint32_t rem = ua - q * ub;
+  for (int i = 0; i < AK_FIXED_SHIFT; i++) {
+    rem <<= 1;
+    q <<= 1;
+    if (rem >= ub) {
+      rem -= ub;
+      q |= 1;
+    }
+  }
+  return (ak_fixed_t)((a < 0) != (b < 0) ? 0u - q : q);
+}
+
+#ifdef AK_MATH_32
+#define AK_FIXED_MUL_RAW(a, b) ak_fixed_mul32((a), (b))
+#define AK_FIXED_DIV_RAW(a, b) ak_fixed_div32((a), (b))
+#else
+#define AK_FIXED_MUL_RAW(a, b) AK_FIXED_MUL_64(a, b)
+#define AK_FIXED_DIV_RAW(a, b) AK_FIXED_DIV_64(a, b)
+#endif
+
+#ifdef AK_COUNT_OPS
+// Cost estimation build: tally each operation (see ak_ops.h)
+#include "ak_ops.h"
+#define AK_FIXED_MUL(a, b) (AK_OPS_TALLY(AK_OP_MUL), AK_FIXED_MUL_RAW(a, b))
+#define AK_FIXED_DIV(a, b) (AK_OPS_TALLY(AK_OP_DIV), AK_FIXED_DIV_RAW(a, b))
+#define AK_FIXED_SQRT(x) (AK_OPS_TALLY(AK_OP_SQRT), ak_fixed_sqrt(x))
+#else
+#define AK_FIXED_MUL(a, b) AK_FIXED_MUL_RAW(a, b)
+#define AK_FIXED_DIV(a, b) AK_FIXED_DIV_RAW(a, b)
+#define AK_FIXED_SQRT(x) ak_fixed_sqrt(x)
+#endif
+
 // Absolute value
 #define AK_FIXED_ABS(a) ((a) < 0 ? -(a) : (a))
 
@@ -36,7 +111,7 @@ typedef int32_t ak_fixed_t;
 #define AK_FIXED_MIN(a, b) ((a) < (b) ? (a) : (b))
 #define AK_FIXED_MAX(a, b) ((a) > (b) ? (a) : (b))
 
-static inline ak_fixed_t AK_FIXED_SQRT(ak_fixed_t x) {
+static inline ak_fixed_t ak_fixed_sqrt(ak_fixed_t x) {
   if (x <= 0)
     return 0;
   // Simple integer sqrt for 16.16 fixed point
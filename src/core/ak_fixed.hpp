@@ -0,0 +1,189 @@
+#ifndef AK_FIXED_HPP
+#define AK_FIXED_HPP
+
+// Header-only C++ wrappers for ak_fixed_t and ak_vec2_t. Every operation
+// computes exactly what the matching C macro or ak_vec2_* function does, so
+// values can be passed to the C API unchanged, but arguments are evaluated
+// once and constant expressions fold at compile time:
+//
+//   constexpr ak::fixed dt = ak::fixed(1) / 60;
+//   constexpr ak::fixed bounce = 0.7_fx;
+//   ak_world_step(&world, dt.raw);
+//
+// Requires C++14 (relaxed constexpr). Operations are not tallied in
+// -DAK_COUNT_OPS builds, since a tally cannot run in a constant expression.
+
+#include "ak_physics.h"
+
+namespace ak {
+
+struct fixed {
+  ak_fixed_t raw;
+
+  constexpr fixed() : raw(0) {}
+  // AK_INT_TO_FIXED, as a multiply so negative constants fold too
+  constexpr fixed(int i) : raw((ak_fixed_t)i * AK_FIXED_ONE) {}
+
+  static constexpr fixed from_raw(ak_fixed_t r) {
+    fixed f;
+    f.raw = r;
+    return f;
+  }
+  // Truncates toward zero, as AK_FLOAT_TO_FIXED
+  static constexpr fixed from_float(double d) {
+    return from_raw((ak_fixed_t)(d * AK_FIXED_ONE));
+  }
+
+  constexpr int to_int() const { return AK_FIXED_TO_INT(raw); }
+  constexpr float to_float() const { return AK_FIXED_TO_FLOAT(raw); }
+
+  constexpr fixed operator-() const { return from_raw(-raw); }
+  constexpr fixed &operator+=(fixed o) {
+    raw = AK_FIXED_ADD(raw, o.raw);
+    return *this;
+  }
+  constexpr fixed &operator-=(fixed o) {
+    raw = AK_FIXED_SUB(raw, o.raw);
+    return *this;
+  }
+  constexpr fixed &operator*=(fixed o) { return *this = *this * o; }
+  constexpr fixed &operator/=(fixed o) { return *this = *this / o; }
+
+  friend constexpr fixed operator+(fixed a, fixed b) {
+    return from_raw(AK_FIXED_ADD(a.raw, b.raw));
+  }
+  friend constexpr fixed operator-(fixed a, fixed b) {
+    return from_raw(AK_FIXED_SUB(a.raw, b.raw));
+  }
+  friend constexpr fixed operator*(fixed a, fixed b) {
+    return from_raw(AK_FIXED_MUL_RAW(a.raw, b.raw));
+  }
+  // AK_FIXED_DIV, with the left shift written as a multiply so it is also a
+  // valid constant expression for negative values
+  friend constexpr fixed operator/(fixed a, fixed b) {
+#ifdef AK_MATH_32
+    return from_raw(ak_fixed_div32(a.raw, b.raw));
+#else
+    return from_raw(
+        (ak_fixed_t)(((int64_t)a.raw * AK_FIXED_ONE) / (int64_t)b.raw));
+#endif
+  }
+
+  friend constexpr bool operator==(fixed a, fixed b) { return a.raw == b.raw; }
+  friend constexpr bool operator!=(fixed a, fixed b) { return a.raw != b.raw; }
+  friend constexpr bool operator<(fixed a, fixed b) { return a.raw < b.raw; }
+  friend constexpr bool operator>(fixed a, fixed b) { return a.raw > b.raw; }
+  friend constexpr bool operator<=(fixed a, fixed b) { return a.raw <= b.raw; }
+  friend constexpr bool operator>=(fixed a, fixed b) { return a.raw >= b.raw; }
+};
+
+constexpr fixed abs(fixed a) { return fixed::from_raw(AK_FIXED_ABS(a.raw)); }
+constexpr fixed min(fixed a, fixed b) { return a < b ? a : b; }
+constexpr fixed max(fixed a, fixed b) { return a > b ? a : b; }
+
+// Integer square root of a 64-bit value, the loop shared by AK_FIXED_SQRT
+// and ak_vec2_len
+constexpr uint64_t isqrt64(uint64_t rem) {
+  uint64_t root = 0;
+  uint64_t place = 1ULL << 62;
+  while (place > rem)
+    place >>= 2;
+  while (place) {
+    if (rem >= root + place) {
+      rem -= root + place;
+      root += place * 2;
+    }
+    root >>= 1;
+    place >>= 2;
+  }
+  return root;
+}
+
+// AK_FIXED_SQRT
+constexpr fixed sqrt(fixed x) {
+  return x.raw <= 0 ? fixed()
+                    : fixed::from_raw((ak_fixed_t)(isqrt64((uint64_t)x.raw)
+                                                   << 8));
+}
+
+namespace literals {
+constexpr fixed operator"" _fx(long double d) {
+  return fixed::from_float((double)d);
+}
+constexpr fixed operator"" _fx(unsigned long long i) { return fixed((int)i); }
+} // namespace literals
+
+struct vec2 {
+  fixed x, y;
+
+  constexpr vec2() : x(), y() {}
+  constexpr vec2(fixed x_, fixed y_) : x(x_), y(y_) {}
+  constexpr vec2(ak_vec2_t v)
+      : x(fixed::from_raw(v.x)), y(fixed::from_raw(v.y)) {}
+  constexpr operator ak_vec2_t() const { return ak_vec2_t{x.raw, y.raw}; }
+
+  constexpr vec2 operator-() const { return vec2(-x, -y); }
+  constexpr vec2 &operator+=(vec2 o) { return *this = *this + o; }
+  constexpr vec2 &operator-=(vec2 o) { return *this = *this - o; }
+  constexpr vec2 &operator*=(fixed s) { return *this = *this * s; }
+
+  friend constexpr vec2 operator+(vec2 a, vec2 b) {
+    return vec2(a.x + b.x, a.y + b.y);
+  }
+  friend constexpr vec2 operator-(vec2 a, vec2 b) {
+    return vec2(a.x - b.x, a.y - b.y);
+  }
+  friend constexpr vec2 operator*(vec2 v, fixed s) {
+    return vec2(v.x * s, v.y * s);
+  }
+  friend constexpr vec2 operator*(fixed s, vec2 v) { return v * s; }
+  friend constexpr bool operator==(vec2 a, vec2 b) {
+    return a.x == b.x && a.y == b.y;
+  }
+  friend constexpr bool operator!=(vec2 a, vec2 b) { return !(a == b); }
+};
+
+// ak_vec2_dot
+constexpr fixed dot(vec2 a, vec2 b) { return a.x * b.x + a.y * b.y; }
+
+// ak_vec2_len_sqr, including its saturation at large components
+constexpr fixed len_sqr(vec2 v) {
+  return (v.x.raw > 8000000 || v.x.raw < -8000000 || v.y.raw > 8000000 ||
+          v.y.raw < -8000000)
+             ? fixed::from_raw(2147483647)
+             : dot(v, v);
+}
+
+// ak_vec2_len
+constexpr fixed len(vec2 v) {
+  int64_t sqr = (int64_t)v.x.raw * v.x.raw + (int64_t)v.y.raw * v.y.raw;
+  return sqr <= 0 ? fixed()
+                  : fixed::from_raw((ak_fixed_t)isqrt64((uint64_t)sqr));
+}
+
+// A lookup table filled at compile time:
+//   constexpr auto sines = ak::make_table<64>(SineOf);
+template <typename T, int N> struct table {
+  T data[N];
+  constexpr const T &operator[](int i) const { return data[i]; }
+  static constexpr int size() { return N; }
+};
+
+template <int N, typename F>
+constexpr auto make_table(F f) -> table<decltype(f(0)), N> {
+  table<decltype(f(0)), N> t{};
+  for (int i = 0; i < N; i++)
+    t.data[i] = f(i);
+  return t;
+}
+
+static_assert(sizeof(fixed) == sizeof(ak_fixed_t), "fixed must wrap raw");
+static_assert(sizeof(vec2) == sizeof(ak_vec2_t), "vec2 must match ak_vec2_t");
+static_assert((fixed(7) / 10).raw ==
+                  AK_FIXED_DIV_RAW(AK_INT_TO_FIXED(7), 10 << 16),
+              "division must match AK_FIXED_DIV");
+static_assert(sqrt(fixed(16)) == fixed(4), "sqrt must match AK_FIXED_SQRT");
+
+} // namespace ak
+
+#endif // AK_FIXED_HPP
@@ -0,0 +1,81 @@
+#include "ak_governor.h"
+#include <stddef.h>
+
+void ak_governor_init(ak_governor_t *gov, const ak_world_t *world,
+                      int32_t budget) {
+  gov->budget = budget;
+  gov->down_steps = 2;
+  gov->up_steps = 60;
+  gov->headroom = AK_INT_TO_FIXED(3) / 4;
+  gov->level = 0;
+  gov->average = 0;
+  gov->over = gov->under = 0;
+  gov->changes = 0;
+  gov->base_slop = world->slop;
+  gov->rope_count = 0;
+  gov->lod = NULL;
+}
+
+// Record the full-quality settings of ropes and a LOD the governor has not
+// seen yet; they are still untouched
+static void Capture(ak_governor_t *gov, const ak_world_t *world) {
+  for (; gov->rope_count < world->rope_count; gov->rope_count++)
+    gov->base_iterations[gov->rope_count] =
+        world->ropes[gov->rope_count].iterations;
+  if (world->lod && world->lod != gov->lod) {
+    gov->lod = world->lod;
+    for (int t = 0; t < AK_LOD_TIERS - 1; t++)
+      gov->base_radius[t] = gov->lod->radius[t];
+  }
+}
+
+static void Apply(ak_governor_t *gov, ak_world_t *world) {
+  int level = gov->level;
+  world->slop = gov->base_slop << (2 * level);
+  for (int i = 0; i < gov->rope_count && i < world->rope_count; i++) {
+    int iterations = gov->base_iterations[i] >> level;
+    if (level == AK_GOVERNOR_LEVELS - 1 || iterations < 1)
+      iterations = 1;
+    world->ropes[i].iterations = iterations;
+  }
+  if (world->lod && world->lod == gov->lod) {
+    int shift = level < 2 ? 0 : level - 1;
+    for (int t = 0; t < AK_LOD_TIERS - 1; t++)
+      world->lod->radius[t] = gov->base_radius[t] >> shift;
+  }
+}
+
+void ak_governor_set_level(ak_governor_t *gov, ak_world_t *world, int level) {
+  if (level < 0)
+    level = 0;
+  if (level > AK_GOVERNOR_LEVELS - 1)
+    level = AK_GOVERNOR_LEVELS - 1;
+  Capture(gov, world);
+  if (level != gov->level)
+    gov->changes++;
+  gov->level = level;
+  gov->over = gov->under = 0;
+  Apply(gov, world);
+}
+
+int ak_governor_update(ak_governor_t *gov, ak_world_t *world, int32_t cost) {
+  gov->average += (cost - gov->average) / 4;
+
+  // Both directions follow the average, so costs that alternate from step
+  // to step (LOD tiers, time-sliced work) do not reset the runs
+  gov->over = gov->average > gov->budget ? gov->over + 1 : 0;
+  gov->under =
+      gov->average < AK_FIXED_MUL(gov->budget, gov->headroom) ? gov->under + 1
+                                                              : 0;
+
+  if (gov->over >= gov->down_steps && gov->level < AK_GOVERNOR_LEVELS - 1) {
+    ak_governor_set_level(gov, world, gov->level + 1);
+  } else if (gov->under >= gov->up_steps && gov->level > 0) {
+    ak_governor_set_level(gov, world, gov->level - 1);
+  } else {
+    // Keep ropes and a LOD added since the last change at the level
+    Capture(gov, world);
+    Apply(gov, world);
+  }
+  return gov->level;
+}
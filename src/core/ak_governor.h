@@ -0,0 +1,68 @@
+#ifndef AK_GOVERNOR_H
+#define AK_GOVERNOR_H
+
+#include "ak_physics.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Adaptive quality. After each step the caller reports what it cost, in
+ * whatever unit it budgets (microseconds, timer ticks, or world->step.work
+ * on targets without a usable clock). While the average cost runs over the
+ * budget the governor lowers the quality level, trading accuracy for speed;
+ * once the average has had headroom for a while it raises it again. Each
+ * level down, from the world's settings at ak_governor_init:
+ *
+ *   level  rope iterations  slop (no positional correction below)  LOD radii
+ *   0      as set           as set                                 as set
+ *   1      1/2              x4                                     as set
+ *   2      1/4              x16                                    1/2
+ *   3      1                x64                                    1/4
+ *
+ * Rope iterations never go below 1. Tethers are a single pass already, so
+ * there is nothing to reduce there. Levels only change between steps, and
+ * while a governor runs it owns these settings.
+ */
+#define AK_GOVERNOR_LEVELS 4
+
+typedef struct {
+  int32_t budget;      // Target cost per step
+  int down_steps;      // Consecutive steps averaging over budget, to go down
+  int up_steps;        // Consecutive steps with headroom, to go up
+  ak_fixed_t headroom; // Headroom: average cost below budget * headroom
+  // State, readable for logging and tuning
+  int level;           // 0 = full quality
+  int32_t average;     // Cost, smoothed over about 4 steps (from 0)
+  int over, under;     // Current runs of steps over budget / with headroom
+  uint32_t changes;    // Level changes so far
+  // Full-quality tunables
+  ak_fixed_t base_slop;
+  int base_iterations[AK_MAX_ROPES];
+  int rope_count; // Ropes whose base iterations are known
+  const ak_lod_t *lod; // LOD whose base radii are held, NULL if none yet
+  ak_fixed_t base_radius[AK_LOD_TIERS - 1];
+} ak_governor_t;
+
+/**
+ * Start at full quality with the world's current tunables as the baseline.
+ * Defaults: down after the average is over budget for 2 steps, up after it
+ * is below 3/4 of the budget for 60. Ropes and a LOD attached later are picked up as
+ * they appear; call this again after any ak_world_init.
+ */
+void ak_governor_init(ak_governor_t *gov, const ak_world_t *world,
+                      int32_t budget);
+/**
+ * Report the cost of the step just taken and adapt the world's tunables for
+ * the next one. Returns the quality level now in effect.
+ */
+int ak_governor_update(ak_governor_t *gov, ak_world_t *world, int32_t cost);
+// Force a quality level (clamped), e.g. to measure each one
+void ak_governor_set_level(ak_governor_t *gov, ak_world_t *world, int level);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_GOVERNOR_H
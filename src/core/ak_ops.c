@@ -0,0 +1,41 @@
+#include "ak_ops.h"
+
+#ifdef AK_COUNT_OPS
+
+#include <string.h>
+
+ak_ops_stats_t ak_ops;
+
+void ak_ops_tally(ak_op_t op, const char *file, int line) {
+  ak_ops.by_phase[ak_ops.phase][op]++;
+
+  // Open addressing on the line number; __FILE__ strings are compared by
+  // pointer first since each translation unit reuses one literal
+  uint32_t h = ((uint32_t)line * 2654435761u) % AK_OPS_MAX_SITES;
+  for (int probe = 0; probe < AK_OPS_MAX_SITES; probe++) {
+    ak_ops_site_t *s = &ak_ops.sites[h];
+    if (!s->file) {
+      s->file = file;
+      s->line = line;
+    }
+    if (s->line == line && (s->file == file || strcmp(s->file, file) == 0)) {
+      s->count[op]++;
+      return;
+    }
+    h = (h + 1) % AK_OPS_MAX_SITES;
+  }
+  ak_ops.lost++;
+}
+
+void ak_ops_reset(void) {
+  ak_phase_t phase = ak_ops.phase;
+  memset(&ak_ops, 0, sizeof(ak_ops));
+  ak_ops.phase = phase;
+}
+
+#else
+
+// ISO C does not allow an empty translation unit
+typedef int ak_ops_disabled_t;
+
+#endif // AK_COUNT_OPS
@@ -0,0 +1,70 @@
+#ifndef AK_OPS_H
+#define AK_OPS_H
+
+#include <stdint.h>
+
+/*
+ * Operation counting build (-DAK_COUNT_OPS). Every AK_FIXED_MUL, AK_FIXED_DIV
+ * and square root is tallied by call site and by the step phase it ran in,
+ * so a host run can estimate the cost on CPUs where these are library calls
+ * or software loops (see src/tools/ak_cost_report.c). Without AK_COUNT_OPS
+ * all of this compiles away.
+ */
+
+typedef enum { AK_OP_MUL, AK_OP_DIV, AK_OP_SQRT, AK_OP_COUNT } ak_op_t;
+
+typedef enum {
+  AK_PHASE_OTHER, // Setup, scene loading, front-end math
+  AK_PHASE_INTEGRATE,
+  AK_PHASE_PAIRS,
+  AK_PHASE_STATICS,
+  AK_PHASE_TILEMAP,
+  AK_PHASE_TETHERS,
+  AK_PHASE_ROPES,
+  AK_PHASE_PARTICLES,
+  AK_PHASE_COUNT
+} ak_phase_t;
+
+#ifdef AK_COUNT_OPS
+
+#ifndef AK_OPS_MAX_SITES
+#define AK_OPS_MAX_SITES 256
+#endif
+
+typedef struct {
+  const char *file; // NULL for an unused slot
+  int line;
+  uint64_t count[AK_OP_COUNT];
+} ak_ops_site_t;
+
+typedef struct {
+  uint64_t by_phase[AK_PHASE_COUNT][AK_OP_COUNT];
+  ak_ops_site_t sites[AK_OPS_MAX_SITES]; // Hashed by file and line
+  uint64_t lost; // Tallies of sites that did not fit the table
+  ak_phase_t phase;
+} ak_ops_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern ak_ops_stats_t ak_ops;
+
+void ak_ops_tally(ak_op_t op, const char *file, int line);
+void ak_ops_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define AK_OPS_TALLY(op) ak_ops_tally((op), __FILE__, __LINE__)
+#define AK_OPS_PHASE(p) (ak_ops.phase = (p))
+
+#else
+
+#define AK_OPS_TALLY(op) ((void)0)
+#define AK_OPS_PHASE(p) ((void)0)
+
+#endif // AK_COUNT_OPS
+
+#endif // AK_OPS_H
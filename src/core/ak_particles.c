@@ -0,0 +1,288 @@
+#include "ak_particles.h"
+#include "ak_ops.h"
+#include <stddef.h>
+
+void ak_particles_init(ak_particles_t *p, ak_fixed_t radius) {
+  p->count = 0;
+  p->radius = radius;
+  p->restitution = AK_FIXED_DIV(AK_INT_TO_FIXED(5), AK_INT_TO_FIXED(10));
+}
+
+int ak_particles_emit(ak_particles_t *p, ak_vec2_t position,
+                      ak_vec2_t velocity, uint16_t life) {
+  if (p->count >= AK_MAX_PARTICLES)
+    return -1;
+  int i = p->count++;
+  p->x[i] = position.x;
+  p->y[i] = position.y;
+  p->vx[i] = velocity.x;
+  p->vy[i] = velocity.y;
+  p->life[i] = life;
+  return i;
+}
+
+void ak_particles_shift(ak_particles_t *p, int32_t dx, int32_t dy) {
+  ak_fixed_t fx = AK_INT_TO_FIXED(dx);
+  ak_fixed_t fy = AK_INT_TO_FIXED(dy);
+  for (int i = 0; i < p->count; i++) {
+    p->x[i] -= fx;
+    p->y[i] -= fy;
+  }
+}
+
+void ak_particles_kill(ak_particles_t *p, int index) {
+  // Swap-remove: the last particle takes this slot
+  int last = --p->count;
+  p->x[index] = p->x[last];
+  p->y[index] = p->y[last];
+  p->vx[index] = p->vx[last];
+  p->vy[index] = p->vy[last];
+  p->life[index] = p->life[last];
+}
+
+// Pushes particle i out of a static circle (reach = radius + particle
+// radius) and reflects its normal velocity
+static void CircleParticle(ak_particles_t *p, int i, const ak_body_t *s,
+                           ak_fixed_t reach, int64_t reach_sqr,
+                           ak_fixed_t bounce) {
+  ak_fixed_t dx = AK_FIXED_SUB(p->x[i], s->position.x);
+  ak_fixed_t dy = AK_FIXED_SUB(p->y[i], s->position.y);
+  if (dx >= reach || dx <= -reach || dy >= reach || dy <= -reach)
+    return;
+  AK_OPS_TALLY(AK_OP_MUL);
+  AK_OPS_TALLY(AK_OP_MUL);
+  if ((int64_t)dx * dx + (int64_t)dy * dy >= reach_sqr)
+    return;
+
+  ak_vec2_t d = {dx, dy};
+  ak_fixed_t dist = AK_VEC2_LEN(d);
+  ak_vec2_t n = (dist == 0) ? (ak_vec2_t){0, -AK_FIXED_ONE}
+                            : AK_VEC2_MUL(d, AK_FIXED_DIV(AK_FIXED_ONE, dist));
+  p->x[i] = AK_FIXED_ADD(s->position.x, AK_FIXED_MUL(n.x, reach));
+  p->y[i] = AK_FIXED_ADD(s->position.y, AK_FIXED_MUL(n.y, reach));
+
+  ak_fixed_t vn = AK_FIXED_ADD(AK_FIXED_MUL(p->vx[i], n.x),
+                               AK_FIXED_MUL(p->vy[i], n.y));
+  if (vn < 0) {
+    ak_fixed_t j = AK_FIXED_MUL(vn, bounce);
+    p->vx[i] = AK_FIXED_SUB(p->vx[i], AK_FIXED_MUL(n.x, j));
+    p->vy[i] = AK_FIXED_SUB(p->vy[i], AK_FIXED_MUL(n.y, j));
+  }
+}
+
+static void CollideCircle(ak_particles_t *p, const ak_body_t *s,
+                          ak_fixed_t bounce) {
+  ak_fixed_t reach = AK_FIXED_ADD(s->shape.bounds.circle.radius, p->radius);
+  int64_t reach_sqr = (int64_t)reach * reach;
+  AK_OPS_TALLY(AK_OP_MUL);
+  for (int i = 0; i < p->count; i++)
+    CircleParticle(p, i, s, reach, reach_sqr, bounce);
+}
+
+// Pushes particle i out of a static AABB (half extents hw, hh grown by the
+// particle radius). The face is chosen by the axis the particle entered from
+// last step, falling back to the shallowest face, so particles do not get
+// shoved out sideways through the top of a floor.
+static void AABBParticle(ak_particles_t *p, int i, const ak_body_t *s,
+                         ak_fixed_t hw, ak_fixed_t hh, ak_fixed_t dt) {
+  ak_fixed_t e = p->restitution;
+  ak_fixed_t dx = AK_FIXED_SUB(p->x[i], s->position.x);
+  ak_fixed_t dy = AK_FIXED_SUB(p->y[i], s->position.y);
+  ak_fixed_t ox = AK_FIXED_SUB(hw, AK_FIXED_ABS(dx));
+  ak_fixed_t oy = AK_FIXED_SUB(hh, AK_FIXED_ABS(dy));
+  if (ox <= 0 || oy <= 0)
+    return;
+
+  ak_fixed_t old_dy = AK_FIXED_SUB(dy, AK_FIXED_MUL(p->vy[i], dt));
+  ak_fixed_t old_dx = AK_FIXED_SUB(dx, AK_FIXED_MUL(p->vx[i], dt));
+  int along_x;
+  if (AK_FIXED_ABS(old_dy) >= hh)
+    along_x = 0;
+  else if (AK_FIXED_ABS(old_dx) >= hw)
+    along_x = 1;
+  else
+    along_x = ox < oy;
+
+  if (along_x) {
+    p->x[i] = s->position.x + (dx < 0 ? -hw : hw);
+    if ((dx < 0) == (p->vx[i] > 0))
+      p->vx[i] = -AK_FIXED_MUL(p->vx[i], e);
+  } else {
+    p->y[i] = s->position.y + (dy < 0 ? -hh : hh);
+    if ((dy < 0) == (p->vy[i] > 0))
+      p->vy[i] = -AK_FIXED_MUL(p->vy[i], e);
+  }
+}
+
+static void CollideAABB(ak_particles_t *p, const ak_body_t *s,
+                        ak_fixed_t dt) {
+  ak_fixed_t hw = AK_FIXED_ADD(s->shape.bounds.aabb.width, p->radius);
+  ak_fixed_t hh = AK_FIXED_ADD(s->shape.bounds.aabb.height, p->radius);
+  for (int i = 0; i < p->count; i++)
+    AABBParticle(p, i, s, hw, hh, dt);
+}
+
+// Grid cell of an offset from the grid's top-left corner, clamped to the grid
+static int StaticCell(const ak_static_world_t *sw, ak_fixed_t rel,
+                      int count) {
+  int32_t c = AK_FIXED_TO_INT(AK_FIXED_MUL(rel, sw->inv_cell_size));
+  return c < 0 ? 0 : c >= count ? count - 1 : (int)c;
+}
+
+// Shared static geometry, one particle at a time: each particle only tests
+// the bodies listed in the grid cells its box overlaps
+static void CollideStatics(ak_particles_t *p, const ak_static_world_t *sw,
+                           ak_fixed_t bounce, ak_fixed_t dt) {
+  ak_fixed_t r = p->radius;
+  for (int i = 0; i < p->count; i++) {
+    ak_fixed_t x = p->x[i], y = p->y[i];
+    if (x + r < sw->min.x || y + r < sw->min.y || x - r > sw->max.x ||
+        y - r > sw->max.y)
+      continue;
+    int cx0 = StaticCell(sw, AK_FIXED_MAX(x - r, sw->min.x) - sw->min.x,
+                         sw->cols);
+    int cy0 = StaticCell(sw, AK_FIXED_MAX(y - r, sw->min.y) - sw->min.y,
+                         sw->rows);
+    int cx1 = StaticCell(sw, AK_FIXED_MIN(x + r, sw->max.x) - sw->min.x,
+                         sw->cols);
+    int cy1 = StaticCell(sw, AK_FIXED_MIN(y + r, sw->max.y) - sw->min.y,
+                         sw->rows);
+    for (int cy = cy0; cy <= cy1; cy++) {
+      for (int cx = cx0; cx <= cx1; cx++) {
+        int c = cy * sw->cols + cx;
+        for (int k = sw->cell_start[c]; k < sw->cell_start[c + 1]; k++) {
+          int b = sw->cell_bodies[k];
+          // Once per body, in the top-left cell of the overlap
+          if ((cx != cx0 && cx != sw->first_col[b]) ||
+              (cy != cy0 && cy != sw->first_row[b]))
+            continue;
+          const ak_body_t *s = &sw->bodies[b];
+          if (s->shape.type == AK_SHAPE_CIRCLE) {
+            ak_fixed_t reach = AK_FIXED_ADD(s->shape.bounds.circle.radius, r);
+            AK_OPS_TALLY(AK_OP_MUL);
+            CircleParticle(p, i, s, reach, (int64_t)reach * reach, bounce);
+          } else {
+            AABBParticle(p, i, s, AK_FIXED_ADD(s->shape.bounds.aabb.width, r),
+                         AK_FIXED_ADD(s->shape.bounds.aabb.height, r), dt);
+          }
+        }
+      }
+    }
+  }
+}
+
+// A world bound (global, 64-bit 16.16) in local coordinates. A bound too far
+// from the local origin to represent becomes `open`, i.e. no wall at all.
+static ak_fixed_t LocalBound(int64_t global, int32_t origin, ak_fixed_t open) {
+  int64_t local = global - (int64_t)origin * AK_FIXED_ONE;
+  if (local > INT32_MAX || local < INT32_MIN)
+    return open;
+  return (ak_fixed_t)local;
+}
+
+static int TileAt(const ak_tilemap_t *map, ak_fixed_t x, ak_fixed_t y) {
+  int32_t tx =
+      AK_FIXED_TO_INT(AK_FIXED_MUL(x - map->origin.x, map->inv_tile_size)) +
+      map->origin_tx;
+  int32_t ty =
+      AK_FIXED_TO_INT(AK_FIXED_MUL(y - map->origin.y, map->inv_tile_size)) +
+      map->origin_ty;
+  if (tx < 0 || ty < 0 || tx >= map->width || ty >= map->height)
+    return 0;
+  return map->tiles[(int32_t)ty * map->width + tx] != 0;
+}
+
+// Particles are points against tiles. A particle that entered a solid tile
+// is put back on the axis that crossed into it and bounced on that axis.
+static void CollideTilemap(ak_particles_t *p, const ak_tilemap_t *map,
+                           ak_fixed_t dt) {
+  ak_fixed_t e = p->restitution;
+  for (int i = 0; i < p->count; i++) {
+    if (!TileAt(map, p->x[i], p->y[i]))
+      continue;
+    ak_fixed_t old_x = AK_FIXED_SUB(p->x[i], AK_FIXED_MUL(p->vx[i], dt));
+    ak_fixed_t old_y = AK_FIXED_SUB(p->y[i], AK_FIXED_MUL(p->vy[i], dt));
+    int hit_x = !TileAt(map, old_x, p->y[i]);
+    int hit_y = !hit_x && !TileAt(map, p->x[i], old_y);
+    if (!hit_x && !hit_y)
+      hit_x = hit_y = 1; // Entered diagonally through a corner
+    if (hit_x) {
+      p->x[i] = old_x;
+      p->vx[i] = -AK_FIXED_MUL(p->vx[i], e);
+    }
+    if (hit_y) {
+      p->y[i] = old_y;
+      p->vy[i] = -AK_FIXED_MUL(p->vy[i], e);
+    }
+  }
+}
+
+void ak_particles_step(ak_particles_t *p, const ak_world_t *world,
+                       ak_fixed_t dt) {
+  AK_OPS_PHASE(AK_PHASE_PARTICLES);
+  int n = p->count;
+  ak_fixed_t gx = AK_FIXED_MUL(world->gravity.x, dt);
+  ak_fixed_t gy = AK_FIXED_MUL(world->gravity.y, dt);
+  ak_fixed_t e = p->restitution;
+  ak_fixed_t bounce = AK_FIXED_ADD(AK_FIXED_ONE, e);
+
+  // Integrate (semi-implicit Euler, as ak_world_step)
+  ak_fixed_t *restrict px = p->x;
+  ak_fixed_t *restrict py = p->y;
+  ak_fixed_t *restrict pvx = p->vx;
+  ak_fixed_t *restrict pvy = p->vy;
+  for (int i = 0; i < n; i++) {
+    pvx[i] += gx;
+    pvy[i] += gy;
+    px[i] += AK_FIXED_MUL(pvx[i], dt);
+    py[i] += AK_FIXED_MUL(pvy[i], dt);
+  }
+
+  // Static bodies, one body at a time over all particles
+  for (int b = 0; b < world->body_count; b++) {
+    const ak_body_t *s = &world->bodies[b];
+    if (!s->is_static)
+      continue;
+    if (s->shape.type == AK_SHAPE_CIRCLE)
+      CollideCircle(p, s, bounce);
+    else
+      CollideAABB(p, s, dt);
+  }
+
+  if (world->statics && world->statics->cols)
+    CollideStatics(p, world->statics, bounce, dt);
+  if (world->tilemap.tiles)
+    CollideTilemap(p, &world->tilemap, dt);
+
+  // World bounds: side walls and floor. The top is open so particles can
+  // be spawned above the screen. The bounds are fixed in global space.
+  ak_fixed_t r = p->radius;
+  ak_fixed_t left = LocalBound(r, world->origin_x, INT32_MIN);
+  ak_fixed_t right =
+      LocalBound((int64_t)world->width - r, world->origin_x, INT32_MAX);
+  ak_fixed_t bottom =
+      LocalBound((int64_t)world->height - r, world->origin_y, INT32_MAX);
+  for (int i = 0; i < n; i++) {
+    if (px[i] < left) {
+      px[i] = left;
+      if (pvx[i] < 0)
+        pvx[i] = -AK_FIXED_MUL(pvx[i], e);
+    } else if (px[i] > right) {
+      px[i] = right;
+      if (pvx[i] > 0)
+        pvx[i] = -AK_FIXED_MUL(pvx[i], e);
+    }
+    if (py[i] > bottom) {
+      py[i] = bottom;
+      if (pvy[i] > 0)
+        pvy[i] = -AK_FIXED_MUL(pvy[i], e);
+    }
+  }
+
+  // Expire, back to front so swap-removal never skips a particle
+  for (int i = n - 1; i >= 0; i--) {
+    if (p->life[i] && --p->life[i] == 0)
+      ak_particles_kill(p, i);
+  }
+  AK_OPS_PHASE(AK_PHASE_OTHER);
+}
@@ -0,0 +1,56 @@
+#ifndef AK_PARTICLES_H
+#define AK_PARTICLES_H
+
+#include "ak_physics.h"
+
+// Per-pool capacity. Pools are caller-owned, so this costs nothing on
+// targets that never declare one.
+#ifndef AK_MAX_PARTICLES
+#define AK_MAX_PARTICLES 256
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Lightweight particles for debris, sparks and rain. Particles share one
+ * radius, fall under the world's gravity and bounce off static bodies
+ * (the world's own and any shared ak_static_world_t), the tilemap and the
+ * world bounds. They never collide with each other or with
+ * dynamic bodies, and are stepped separately from ak_world_step.
+ */
+typedef struct {
+  // Structure of arrays so the integration loop vectorizes
+  ak_fixed_t x[AK_MAX_PARTICLES];
+  ak_fixed_t y[AK_MAX_PARTICLES];
+  ak_fixed_t vx[AK_MAX_PARTICLES];
+  ak_fixed_t vy[AK_MAX_PARTICLES];
+  uint16_t life[AK_MAX_PARTICLES]; // Steps left; 0 = lives until killed
+  int count;
+  ak_fixed_t radius;
+  ak_fixed_t restitution;
+} ak_particles_t;
+
+void ak_particles_init(ak_particles_t *p, ak_fixed_t radius);
+/**
+ * Spawn a particle. life is in steps (0 = no expiry). Returns its index, or
+ * -1 if the pool is full. Indices are not stable across steps.
+ */
+int ak_particles_emit(ak_particles_t *p, ak_vec2_t position,
+                      ak_vec2_t velocity, uint16_t life);
+void ak_particles_kill(ak_particles_t *p, int index);
+// Follow an ak_world_shift_origin of the world the pool is stepped against
+void ak_particles_shift(ak_particles_t *p, int32_t dx, int32_t dy);
+/**
+ * Advance all particles by dt against the world's gravity, static bodies,
+ * tilemap and bounds. The world is only read.
+ */
+void ak_particles_step(ak_particles_t *p, const ak_world_t *world,
+                       ak_fixed_t dt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_PARTICLES_H
@@ -1,4 +1,6 @@
 #include "ak_physics.h"
+#include "ak_commands.h"
+#include "ak_ops.h"
 #include <stddef.h>
 
 // --- Vector Math ---
@@ -12,21 +14,25 @@ ak_vec2_t ak_vec2_sub(ak_vec2_t a, ak_vec2_t b) {
 }
 
 ak_vec2_t ak_vec2_mul(ak_vec2_t v, ak_fixed_t s) {
-  return (ak_vec2_t){AK_FIXED_MUL(v.x, s), AK_FIXED_MUL(v.y, s)};
+  return (ak_vec2_t){AK_FIXED_MUL_RAW(v.x, s), AK_FIXED_MUL_RAW(v.y, s)};
 }
 
 ak_fixed_t ak_vec2_dot(ak_vec2_t a, ak_vec2_t b) {
-  return AK_FIXED_ADD(AK_FIXED_MUL(a.x, b.x), AK_FIXED_MUL(a.y, b.y));
+  return AK_FIXED_ADD(AK_FIXED_MUL_RAW(a.x, b.x), AK_FIXED_MUL_RAW(a.y, b.y));
+}
+
+// A diagonal for 320x240 is 400. 400px = 26,214,400 raw fixed.
+// We use 64-bit to compute the square safely, but the result must fit in
+// 32-bit. x^2 >> 16 < 2^31 => x^2 < 2^47 => x < 11,863,283. Since we sum x^2
+// + y^2, we should limit to ~8M each.
+static int LenSqrSaturates(ak_vec2_t v) {
+  const ak_fixed_t LIMIT = 8000000;
+  return v.x > LIMIT || v.x < -LIMIT || v.y > LIMIT || v.y < -LIMIT;
 }
 
 // Safe length squared to prevent overflow
 ak_fixed_t ak_vec2_len_sqr(ak_vec2_t v) {
-  // A diagonal for 320x240 is 400. 400px = 26,214,400 raw fixed.
-  // We use 64-bit to compute the square safely, but the result must fit in
-  // 32-bit. x^2 >> 16 < 2^31 => x^2 < 2^47 => x < 11,863,283. Since we sum x^2
-  // + y^2, we should limit to ~8M each.
-  const ak_fixed_t LIMIT = 8000000;
-  if (v.x > LIMIT || v.x < -LIMIT || v.y > LIMIT || v.y < -LIMIT) {
+  if (LenSqrSaturates(v)) {
     return 2147483647; // INT32_MAX
   }
   return ak_vec2_dot(v, v);
@@ -69,6 +75,37 @@ ak_fixed_t ak_vec2_len(ak_vec2_t v) {
   return (ak_fixed_t)root;
 }
 
+#ifdef AK_COUNT_OPS
+ak_vec2_t ak_vec2_mul_at(ak_vec2_t v, ak_fixed_t s, const char *file,
+                         int line) {
+  ak_ops_tally(AK_OP_MUL, file, line);
+  ak_ops_tally(AK_OP_MUL, file, line);
+  return ak_vec2_mul(v, s);
+}
+
+ak_fixed_t ak_vec2_dot_at(ak_vec2_t a, ak_vec2_t b, const char *file,
+                          int line) {
+  ak_ops_tally(AK_OP_MUL, file, line);
+  ak_ops_tally(AK_OP_MUL, file, line);
+  return ak_vec2_dot(a, b);
+}
+
+ak_fixed_t ak_vec2_len_sqr_at(ak_vec2_t v, const char *file, int line) {
+  if (!LenSqrSaturates(v)) {
+    ak_ops_tally(AK_OP_MUL, file, line);
+    ak_ops_tally(AK_OP_MUL, file, line);
+  }
+  return ak_vec2_len_sqr(v);
+}
+
+ak_fixed_t ak_vec2_len_at(ak_vec2_t v, const char *file, int line) {
+  ak_ops_tally(AK_OP_MUL, file, line);
+  ak_ops_tally(AK_OP_MUL, file, line);
+  ak_ops_tally(AK_OP_SQRT, file, line);
+  return ak_vec2_len(v);
+}
+#endif
+
 // -- World --
 
 void ak_world_init(ak_world_t *world, ak_fixed_t width, ak_fixed_t height,
@@ -78,6 +115,18 @@ void ak_world_init(ak_world_t *world, ak_fixed_t width, ak_fixed_t height,
   world->gravity = gravity;
   world->body_count = 0;
   world->tether_count = 0;
+  world->rope_count = 0;
+  world->rope_node_count = 0;
+  world->tilemap.tiles = NULL;
+  world->statics = NULL;
+  world->commands = NULL;
+  world->lod = NULL;
+  world->sort_interval = 0;
+  world->sort_countdown = 0;
+  world->step.phase = AK_STEP_IDLE;
+  world->step.work = 0;
+  world->origin_x = 0;
+  world->origin_y = 0;
 
   // Scale constants relative to height (standard height 240)
   ak_fixed_t scale_y = AK_FIXED_DIV(height, AK_INT_TO_FIXED(240));
@@ -92,93 +141,436 @@ ak_body_t *ak_world_add_body(ak_world_t *world, ak_shape_t shape, ak_fixed_t x,
     return 0;
   }
   ak_body_t *b = &world->bodies[world->body_count++];
+  b->id = 0; // The slot may hold a removed body's
   b->position = (ak_vec2_t){x, y};
   b->velocity = (ak_vec2_t){0, 0};
   b->force = (ak_vec2_t){0, 0};
   b->shape = shape;
+  b->mass = mass;
   b->inv_mass = (mass > 0) ? AK_FIXED_DIV(AK_FIXED_ONE, mass) : 0;
   b->restitution = AK_FIXED_DIV(AK_INT_TO_FIXED(7), AK_INT_TO_FIXED(10)); // 0.7
   b->is_static = (mass == 0);
   return b;
 }
 
+int ak_body_valid(ak_shape_t shape, ak_fixed_t mass) {
+  // Raw masses of 1 or 2 overflow 1/mass to 0 or a negative inverse
+  if (mass < 0 || (mass > 0 && AK_FIXED_DIV(AK_FIXED_ONE, mass) <= 0))
+    return 0;
+  if (shape.type == AK_SHAPE_AABB)
+    return shape.bounds.aabb.width > 0 && shape.bounds.aabb.height > 0;
+  if (shape.type == AK_SHAPE_CIRCLE)
+    return shape.bounds.circle.radius > 0;
+  return 0;
+}
+
 void ak_world_add_tether(ak_world_t *world, ak_body_t *a, ak_body_t *b,
                          ak_fixed_t max_length) {
   if (world->tether_count >= AK_MAX_TETHERS)
     return;
   ak_tether_t *t = &world->tethers[world->tether_count++];
-  t->a = a;
-  t->b = b;
-  t->max_length_sqr = AK_FIXED_MUL(max_length, max_length);
+  t->a = (int)(a - world->bodies);
+  t->b = (int)(b - world->bodies);
+  t->max_length = max_length;
+  // Squared length only fits 16.16 below ~181px; longer tethers skip the
+  // squared early-out and always take the 64-bit length.
+  t->max_length_sqr = (max_length < AK_INT_TO_FIXED(181))
+                          ? AK_FIXED_MUL(max_length, max_length)
+                          : 0;
 }
 
-static void ResolveTethers(ak_world_t *world) {
-  for (int i = 0; i < world->tether_count; i++) {
-    ak_tether_t *t = &world->tethers[i];
-    ak_vec2_t diff = ak_vec2_sub(t->b->position, t->a->position);
+static void ResolveTetherBodies(const ak_tether_t *t, ak_body_t *a,
+                                ak_body_t *b, ak_fixed_t max_corr) {
+  ak_vec2_t diff = ak_vec2_sub(b->position, a->position);
+  ak_fixed_t max_len = t->max_length;
+
+  // Quick rejection: slack tethers never need the square root
+  if (t->max_length_sqr && AK_FIXED_ABS(diff.x) <= max_len &&
+      AK_FIXED_ABS(diff.y) <= max_len &&
+      AK_VEC2_LEN_SQR(diff) <= t->max_length_sqr)
+    return;
+
+  // Calculate precise safe length (64-bit friendly)
+  ak_fixed_t dist = AK_VEC2_LEN(diff);
+
+  if (dist <= max_len)
+    return;
+
+  ak_fixed_t excess = AK_FIXED_SUB(dist, max_len);
+
+  // Normalize diff to get direction: n = diff / dist
+  ak_vec2_t n = AK_VEC2_MUL(diff, AK_FIXED_DIV(AK_FIXED_ONE, dist));
 
-    // Optimization: Quick AABB rejection first
-    ak_fixed_t max_len = AK_FIXED_SQRT(t->max_length_sqr);
+  // SOFT CONSTRAINT & STABILIZATION
+  const ak_fixed_t stiffness = AK_INT_TO_FIXED(5) / 10; // 0.5
+  ak_fixed_t correction_mag = AK_FIXED_MUL(excess, stiffness);
 
-    // Quick rejection: if either component > max_len, we are definitely outside
-    if (AK_FIXED_ABS(diff.x) <= max_len && AK_FIXED_ABS(diff.y) <= max_len) {
-      // Safe to use squared checks if we wanted, but sticking to safe length.
+  // Clamp correction
+  if (correction_mag > max_corr)
+    correction_mag = max_corr;
+
+  ak_vec2_t move = AK_VEC2_MUL(n, correction_mag);
+
+  ak_fixed_t total_imass = AK_FIXED_ADD(a->inv_mass, b->inv_mass);
+  if (total_imass == 0)
+    return;
+
+  if (!a->is_static) {
+    ak_fixed_t share = AK_FIXED_DIV(a->inv_mass, total_imass);
+    a->position = ak_vec2_add(a->position, AK_VEC2_MUL(move, share));
+
+    ak_fixed_t vrel = AK_VEC2_DOT(ak_vec2_sub(b->velocity, a->velocity), n);
+    if (vrel > 0) {
+      // Apply impulse to kill relative velocity
+      // P = vrel / total_imass (magnitude of impulse)
+      // dV = P * inv_mass * n
+      ak_vec2_t P = AK_VEC2_MUL(n, AK_FIXED_DIV(vrel, total_imass));
+      a->velocity = ak_vec2_add(a->velocity, AK_VEC2_MUL(P, a->inv_mass));
+    }
+  }
+  if (!b->is_static) {
+    ak_fixed_t share = AK_FIXED_DIV(b->inv_mass, total_imass);
+    b->position = ak_vec2_sub(b->position, AK_VEC2_MUL(move, share));
+
+    ak_fixed_t vrel = AK_VEC2_DOT(ak_vec2_sub(b->velocity, a->velocity), n);
+    if (vrel > 0) {
+      ak_vec2_t P = AK_VEC2_MUL(n, AK_FIXED_DIV(vrel, total_imass));
+      b->velocity = ak_vec2_sub(b->velocity, AK_VEC2_MUL(P, b->inv_mass));
     }
+  }
+}
+
+static void ResolveTether(ak_world_t *world, ak_tether_t *t) {
+  ResolveTetherBodies(t, &world->bodies[t->a], &world->bodies[t->b],
+                      world->max_correction);
+}
 
-    // Calculate precise safe length (64-bit friendly)
-    ak_fixed_t dist = ak_vec2_len(diff);
+void ak_world_remove_body(ak_world_t *world, ak_body_t *body) {
+  int index = (int)(body - world->bodies);
+  if (index < 0 || index >= world->body_count)
+    return;
 
-    if (dist <= max_len)
+  // Drop its tethers and renumber the rest, keeping their order
+  int kept = 0;
+  for (int i = 0; i < world->tether_count; i++) {
+    ak_tether_t t = world->tethers[i];
+    if (t.a == index || t.b == index)
       continue;
+    if (t.a > index)
+      t.a--;
+    if (t.b > index)
+      t.b--;
+    world->tethers[kept++] = t;
+  }
+  world->tether_count = kept;
+
+  for (int i = 0; i < world->rope_count; i++) {
+    ak_rope_t *rope = &world->ropes[i];
+    if (rope->body_a == index)
+      rope->body_a = -1;
+    else if (rope->body_a > index)
+      rope->body_a--;
+    if (rope->body_b == index)
+      rope->body_b = -1;
+    else if (rope->body_b > index)
+      rope->body_b--;
+  }
 
-    ak_fixed_t excess = AK_FIXED_SUB(dist, max_len);
+  world->body_count--;
+  for (int i = index; i < world->body_count; i++)
+    world->bodies[i] = world->bodies[i + 1];
+
+  ak_lod_t *lod = world->lod;
+  if (lod && index < lod->body_count) {
+    lod->body_count--;
+    for (int i = index; i < lod->body_count; i++) {
+      lod->tier[i] = lod->tier[i + 1];
+      lod->owed[i] = lod->owed[i + 1];
+      lod->active[i] = lod->active[i + 1];
+    }
+  }
+}
 
-    // Normalize diff to get direction: n = diff / dist
-    ak_vec2_t n = ak_vec2_mul(diff, AK_FIXED_DIV(AK_FIXED_ONE, dist));
+ak_body_t *ak_world_find_body(ak_world_t *world, int id) {
+  for (int i = 0; i < world->body_count; i++) {
+    if (world->bodies[i].id == id)
+      return &world->bodies[i];
+  }
+  return 0;
+}
 
-    // SOFT CONSTRAINT & STABILIZATION
-    const ak_fixed_t stiffness = AK_INT_TO_FIXED(5) / 10; // 0.5
-    ak_fixed_t correction_mag = AK_FIXED_MUL(excess, stiffness);
+// --- Spatial ordering ---
 
-    // Clamp correction
-    ak_fixed_t max_corr = world->max_correction;
-    if (correction_mag > max_corr)
-      correction_mag = max_corr;
+// Interleaves the low 16 bits of v with zeros
+static uint32_t SpreadBits(uint32_t v) {
+  v &= 0xFFFF;
+  v = (v | (v << 8)) & 0x00FF00FFu;
+  v = (v | (v << 4)) & 0x0F0F0F0Fu;
+  v = (v | (v << 2)) & 0x33333333u;
+  return (v | (v << 1)) & 0x55555555u;
+}
 
-    ak_vec2_t move = ak_vec2_mul(n, correction_mag);
+static uint32_t MortonKey(ak_vec2_t p) {
+  // Whole pixels biased to unsigned, then 16px cells
+  uint32_t cx = ((uint32_t)(p.x >> AK_FIXED_SHIFT) + 32768u) >> 4;
+  uint32_t cy = ((uint32_t)(p.y >> AK_FIXED_SHIFT) + 32768u) >> 4;
+  return SpreadBits(cx) | (SpreadBits(cy) << 1);
+}
 
-    ak_fixed_t total_imass = AK_FIXED_ADD(t->a->inv_mass, t->b->inv_mass);
-    if (total_imass == 0)
-      continue;
+// Moves body src (and its LOD state) into slot dst
+static void MoveBody(ak_world_t *world, int dst, int src) {
+  world->bodies[dst] = world->bodies[src];
+  ak_lod_t *lod = world->lod;
+  if (lod) {
+    lod->tier[dst] = lod->tier[src];
+    lod->owed[dst] = lod->owed[src];
+    lod->active[dst] = lod->active[src];
+  }
+}
 
-    if (!t->a->is_static) {
-      ak_fixed_t share = AK_FIXED_DIV(t->a->inv_mass, total_imass);
-      t->a->position = ak_vec2_add(t->a->position, ak_vec2_mul(move, share));
-
-      ak_fixed_t vrel =
-          ak_vec2_dot(ak_vec2_sub(t->b->velocity, t->a->velocity), n);
-      if (vrel > 0) {
-        // Apply impulse to kill relative velocity
-        // P = vrel / total_imass (magnitude of impulse)
-        // dV = P * inv_mass * n
-        ak_vec2_t P = ak_vec2_mul(n, AK_FIXED_DIV(vrel, total_imass));
-        t->a->velocity =
-            ak_vec2_add(t->a->velocity, ak_vec2_mul(P, t->a->inv_mass));
-      }
+int ak_world_sort_bodies(ak_world_t *world, int *remap) {
+  int n = world->body_count;
+  uint32_t keys[AK_MAX_BODIES];
+  uint16_t order[AK_MAX_BODIES];  // Old index of each new slot
+  uint16_t new_of[AK_MAX_BODIES]; // New slot of each old index
+
+  // LOD state past its body_count is stale; start those bodies afresh
+  ak_lod_t *lod = world->lod;
+  if (lod) {
+    for (int i = lod->body_count; i < n; i++)
+      lod->owed[i] = lod->tier[i] = lod->active[i] = 0;
+    lod->body_count = n;
+  }
+
+  // Insertion sort: stable, and close to linear when only a few bodies
+  // changed cells since the last sort
+  for (int i = 0; i < n; i++) {
+    uint32_t key = keys[i] = MortonKey(world->bodies[i].position);
+    int j = i;
+    for (; j > 0 && keys[order[j - 1]] > key; j--)
+      order[j] = order[j - 1];
+    order[j] = (uint16_t)i;
+  }
+
+  int moved = 0;
+  for (int i = 0; i < n; i++) {
+    new_of[order[i]] = (uint16_t)i;
+    moved |= order[i] != i;
+  }
+  if (remap) {
+    for (int i = 0; i < n; i++)
+      remap[i] = new_of[i];
+  }
+  if (!moved)
+    return 0;
+
+  // Apply the permutation in place, one cycle at a time; order[j] = j marks
+  // slots already filled
+  for (int s = 0; s < n; s++) {
+    if (order[s] == s)
+      continue;
+    ak_body_t body = world->bodies[s];
+    uint8_t tier = 0, owed = 0, active = 0;
+    if (lod) {
+      tier = lod->tier[s];
+      owed = lod->owed[s];
+      active = lod->active[s];
     }
-    if (!t->b->is_static) {
-      ak_fixed_t share = AK_FIXED_DIV(t->b->inv_mass, total_imass);
-      t->b->position = ak_vec2_sub(t->b->position, ak_vec2_mul(move, share));
+    int j = s;
+    while (order[j] != s) {
+      int k = order[j];
+      MoveBody(world, j, k);
+      order[j] = (uint16_t)j;
+      j = k;
+    }
+    world->bodies[j] = body;
+    if (lod) {
+      lod->tier[j] = tier;
+      lod->owed[j] = owed;
+      lod->active[j] = active;
+    }
+    order[j] = (uint16_t)j;
+  }
+
+  for (int i = 0; i < world->tether_count; i++) {
+    world->tethers[i].a = new_of[world->tethers[i].a];
+    world->tethers[i].b = new_of[world->tethers[i].b];
+  }
+  for (int i = 0; i < world->rope_count; i++) {
+    ak_rope_t *rope = &world->ropes[i];
+    if (rope->body_a >= 0)
+      rope->body_a = new_of[rope->body_a];
+    if (rope->body_b >= 0)
+      rope->body_b = new_of[rope->body_b];
+  }
+  return 1;
+}
+
+void ak_world_set_sort_interval(ak_world_t *world, int steps) {
+  world->sort_interval = steps;
+  world->sort_countdown = steps;
+}
+
+// Runs the automatic sort when it is due
+static void SortIfDue(ak_world_t *world) {
+  if (world->sort_interval > 0 && --world->sort_countdown <= 0) {
+    ak_world_sort_bodies(world, NULL);
+    world->sort_countdown = world->sort_interval;
+  }
+}
+
+void ak_world_set_commands(ak_world_t *world,
+                           struct ak_command_queue *commands) {
+  world->commands = commands;
+}
+
+// --- Ropes ---
+
+ak_rope_t *ak_world_add_rope(ak_world_t *world, ak_vec2_t start,
+                             ak_vec2_t end, int segments,
+                             ak_fixed_t node_mass) {
+  int nodes = segments + 1;
+  if (segments < 1 || node_mass <= 0 || world->rope_count >= AK_MAX_ROPES ||
+      world->rope_node_count + nodes > AK_MAX_ROPE_NODES)
+    return 0;
+  ak_fixed_t inv_node_mass = AK_FIXED_DIV(AK_FIXED_ONE, node_mass);
+  if (inv_node_mass <= 0)
+    return 0; // 1/node_mass overflowed
+
+  ak_rope_t *r = &world->ropes[world->rope_count++];
+  r->first_node = world->rope_node_count;
+  r->node_count = nodes;
+  r->body_a = -1;
+  r->body_b = -1;
+  r->iterations = AK_ROPE_ITERATIONS;
+  r->node_mass = node_mass;
+  r->inv_node_mass = inv_node_mass;
+
+  ak_vec2_t span = ak_vec2_sub(end, start);
+  ak_vec2_t step = {span.x / segments, span.y / segments};
+  r->rest_length = AK_VEC2_LEN(step);
+  r->rest_length_sqr = AK_FIXED_MUL(r->rest_length, r->rest_length);
+
+  ak_rope_node_t *n = &world->rope_nodes[r->first_node];
+  for (int i = 0; i < nodes; i++) {
+    n[i].position = (ak_vec2_t){start.x + step.x * i, start.y + step.y * i};
+    n[i].velocity = (ak_vec2_t){0, 0};
+  }
+  world->rope_node_count += nodes;
+  return r;
+}
 
-      ak_fixed_t vrel =
-          ak_vec2_dot(ak_vec2_sub(t->b->velocity, t->a->velocity), n);
-      if (vrel > 0) {
-        ak_vec2_t P = ak_vec2_mul(n, AK_FIXED_DIV(vrel, total_imass));
-        t->b->velocity =
-            ak_vec2_sub(t->b->velocity, ak_vec2_mul(P, t->b->inv_mass));
+void ak_rope_attach(ak_world_t *world, ak_rope_t *rope, int end,
+                    ak_body_t *body) {
+  int index = body ? (int)(body - world->bodies) : -1;
+  ak_rope_node_t *node;
+  if (end == 0) {
+    rope->body_a = index;
+    node = &world->rope_nodes[rope->first_node];
+  } else {
+    rope->body_b = index;
+    node = &world->rope_nodes[rope->first_node + rope->node_count - 1];
+  }
+  if (body)
+    node->position = body->position;
+}
+
+// Position-based rope solver. Nodes are integrated to predicted positions,
+// the links are relaxed with a fixed number of Gauss-Seidel sweeps, and the
+// node velocities are derived from the net displacement. Each link uses the
+// square-root-free first-order length estimate, so a sweep costs one
+// division per link: delta *= r^2 / (d^2 + r^2) - 1/2. Links too long for
+// d^2 to fit 16.16 take the exact length instead.
+static void ResolveRope(ak_world_t *world, ak_rope_t *rope, ak_fixed_t dt) {
+  ak_fixed_t inv_dt = AK_FIXED_DIV(AK_FIXED_ONE, dt);
+  ak_vec2_t gravity_dt = AK_VEC2_MUL(world->gravity, dt);
+
+  ak_rope_node_t *nodes = &world->rope_nodes[rope->first_node];
+  int last = rope->node_count - 1;
+  ak_body_t *ba = rope->body_a >= 0 ? &world->bodies[rope->body_a] : NULL;
+  ak_body_t *bb = rope->body_b >= 0 ? &world->bodies[rope->body_b] : NULL;
+
+  // Inverse masses of the end nodes: pinned ends take the body's mass so
+  // the rope can pull dynamic bodies, and never moves static ones.
+  ak_fixed_t w_first = ba ? ba->inv_mass : rope->inv_node_mass;
+  ak_fixed_t w_last = bb ? bb->inv_mass : rope->inv_node_mass;
+  ak_fixed_t w_node = rope->inv_node_mass;
+
+  // Predict. Velocities temporarily hold the start-of-step positions.
+  for (int i = 0; i <= last; i++) {
+    ak_rope_node_t *n = &nodes[i];
+    ak_vec2_t start = n->position;
+    n->velocity = ak_vec2_add(n->velocity, gravity_dt);
+    n->position = ak_vec2_add(n->position, AK_VEC2_MUL(n->velocity, dt));
+    n->velocity = start;
+  }
+  if (ba)
+    nodes[0].position = ba->position;
+  if (bb)
+    nodes[last].position = bb->position;
+
+  for (int it = 0; it < rope->iterations; it++) {
+    for (int i = 0; i < last; i++) {
+      ak_rope_node_t *p = &nodes[i];
+      ak_rope_node_t *q = &nodes[i + 1];
+      ak_fixed_t wp = (i == 0) ? w_first : w_node;
+      ak_fixed_t wq = (i + 1 == last) ? w_last : w_node;
+      ak_fixed_t wsum = AK_FIXED_ADD(wp, wq);
+      if (wsum == 0)
+        continue;
+
+      ak_vec2_t d = ak_vec2_sub(q->position, p->position);
+      ak_fixed_t d2 = AK_VEC2_LEN_SQR(d);
+      ak_fixed_t k;
+      if (d2 <= INT32_MAX - rope->rest_length_sqr) {
+        k = AK_FIXED_SUB(AK_FIXED_DIV(rope->rest_length_sqr,
+                                      AK_FIXED_ADD(d2, rope->rest_length_sqr)),
+                         AK_FIXED_HALF);
+      } else {
+        // Stretched past what the square holds (e.g. an end just attached
+        // to a distant body): the exact (rest - len) / (2 len) instead
+        ak_fixed_t len = AK_VEC2_LEN(d);
+        k = AK_FIXED_DIV(AK_FIXED_SUB(rope->rest_length, len), len * 2);
+      }
+      // k is the correction for equal masses (each node moves by half)
+      ak_vec2_t delta = AK_VEC2_MUL(d, k);
+
+      if (wp == wq) {
+        p->position = ak_vec2_sub(p->position, delta);
+        q->position = ak_vec2_add(q->position, delta);
+      } else {
+        // Redistribute the symmetric correction by inverse mass share
+        ak_vec2_t full = {delta.x * 2, delta.y * 2};
+        ak_fixed_t sp = AK_FIXED_DIV(wp, wsum);
+        p->position = ak_vec2_sub(p->position, AK_VEC2_MUL(full, sp));
+        q->position =
+            ak_vec2_add(q->position, AK_VEC2_MUL(full, AK_FIXED_ONE - sp));
       }
     }
   }
+
+  // Derive velocities from the displacement over the step
+  for (int i = 0; i <= last; i++) {
+    ak_rope_node_t *n = &nodes[i];
+    ak_vec2_t moved = ak_vec2_sub(n->position, n->velocity);
+    n->velocity = AK_VEC2_MUL(moved, inv_dt);
+  }
+
+  // Feed the pinned ends back to dynamic bodies
+  if (ba && !ba->is_static) {
+    ak_vec2_t corr = ak_vec2_sub(nodes[0].position, ba->position);
+    ba->position = nodes[0].position;
+    ba->velocity = ak_vec2_add(ba->velocity, AK_VEC2_MUL(corr, inv_dt));
+  }
+  if (bb && !bb->is_static) {
+    ak_vec2_t corr = ak_vec2_sub(nodes[last].position, bb->position);
+    bb->position = nodes[last].position;
+    bb->velocity = ak_vec2_add(bb->velocity, AK_VEC2_MUL(corr, inv_dt));
+  }
+  if (ba)
+    nodes[0].velocity = ba->velocity;
+  if (bb)
+    nodes[last].velocity = bb->velocity;
 }
 
 // --- Collision ---
@@ -191,25 +583,40 @@ typedef struct {
   int has_collision;
 } ak_manifold_t;
 
+// Circles with a radius (or radius sum) above this are tested with 64-bit
+// distances: their squared radius and the offsets that matter no longer fit
+// the 32-bit squared test, which is exact below it (see ak_vec2_len_sqr).
+#define AK_LARGE_RADIUS 8000000
+
 ak_manifold_t SolveCircleCircle(ak_body_t *a, ak_body_t *b) {
   ak_manifold_t m = {a, b, {0, 0}, 0, 0};
   ak_vec2_t n = ak_vec2_sub(b->position, a->position);
-  ak_fixed_t dist_sqr = ak_vec2_len_sqr(n);
   ak_fixed_t r = AK_FIXED_ADD(a->shape.bounds.circle.radius,
                               b->shape.bounds.circle.radius);
+  ak_fixed_t dist;
+
+  if (r > AK_LARGE_RADIUS) {
+    if (AK_FIXED_ABS(n.x) >= r || AK_FIXED_ABS(n.y) >= r)
+      return m;
+    dist = AK_VEC2_LEN(n);
+    if (dist >= r)
+      return m;
+  } else {
+    ak_fixed_t dist_sqr = AK_VEC2_LEN_SQR(n);
+    if (dist_sqr >= AK_FIXED_MUL(r, r))
+      return m;
+    dist = dist_sqr ? AK_FIXED_SQRT(dist_sqr) : 0;
+  }
 
-  if (dist_sqr >= AK_FIXED_MUL(r, r))
-    return m;
-  if (dist_sqr == 0) {
+  if (dist == 0) {
     m.depth = r;
     m.normal = (ak_vec2_t){AK_FIXED_ONE, 0};
     m.has_collision = 1;
     return m;
   }
 
-  ak_fixed_t dist = AK_FIXED_SQRT(dist_sqr);
   m.depth = AK_FIXED_SUB(r, dist);
-  m.normal = ak_vec2_mul(n, AK_FIXED_DIV(AK_FIXED_ONE, dist));
+  m.normal = AK_VEC2_MUL(n, AK_FIXED_DIV(AK_FIXED_ONE, dist));
   m.has_collision = 1;
   return m;
 }
@@ -255,15 +662,25 @@ ak_manifold_t SolveCircleAABB(ak_body_t *circle, ak_body_t *aabb) {
 
   ak_vec2_t closest = {clamped_x, clamped_y};
   ak_vec2_t n = ak_vec2_sub(diff, closest);
-  ak_fixed_t dist_sqr = ak_vec2_len_sqr(n);
   ak_fixed_t r = circle->shape.bounds.circle.radius;
-
-  if (dist_sqr > AK_FIXED_MUL(r, r))
-    return m;
+  ak_fixed_t dist;
+
+  if (r > AK_LARGE_RADIUS) {
+    if (AK_FIXED_ABS(n.x) > r || AK_FIXED_ABS(n.y) > r)
+      return m;
+    dist = AK_VEC2_LEN(n);
+    if (dist > r)
+      return m;
+  } else {
+    ak_fixed_t dist_sqr = AK_VEC2_LEN_SQR(n);
+    if (dist_sqr > AK_FIXED_MUL(r, r))
+      return m;
+    dist = dist_sqr ? AK_FIXED_SQRT(dist_sqr) : 0;
+  }
 
   m.has_collision = 1;
 
-  if (dist_sqr == 0) {
+  if (dist == 0) {
     if (AK_FIXED_ABS(diff.x) > AK_FIXED_ABS(diff.y)) {
       m.depth = AK_FIXED_ADD(r, half_w);
       // Normal from Circle to AABB (A->B)
@@ -276,21 +693,20 @@ ak_manifold_t SolveCircleAABB(ak_body_t *circle, ak_body_t *aabb) {
     }
     m.depth = r;
   } else {
-    ak_fixed_t dist = AK_FIXED_SQRT(dist_sqr);
     m.depth = AK_FIXED_SUB(r, dist);
     // n is Box->Circle. We want A->B (Circle->Box). So negate.
-    m.normal = ak_vec2_mul(n, -AK_FIXED_DIV(AK_FIXED_ONE, dist));
+    m.normal = AK_VEC2_MUL(n, -AK_FIXED_DIV(AK_FIXED_ONE, dist));
   }
 
   return m;
 }
 
-static void ResolveCollision(ak_world_t *world, ak_manifold_t *m) {
+static void ResolveContact(ak_manifold_t *m, ak_fixed_t slop) {
   if (!m->has_collision)
     return;
 
   ak_vec2_t rv = ak_vec2_sub(m->b->velocity, m->a->velocity);
-  ak_fixed_t vel_along_normal = ak_vec2_dot(rv, m->normal);
+  ak_fixed_t vel_along_normal = AK_VEC2_DOT(rv, m->normal);
 
   if (vel_along_normal > 0)
     return;
@@ -304,86 +720,1162 @@ static void ResolveCollision(ak_world_t *world, ak_manifold_t *m) {
 
   j = AK_FIXED_DIV(j, den);
 
-  ak_vec2_t impulse = ak_vec2_mul(m->normal, j);
+  ak_vec2_t impulse = AK_VEC2_MUL(m->normal, j);
 
   if (!m->a->is_static)
     m->a->velocity =
-        ak_vec2_sub(m->a->velocity, ak_vec2_mul(impulse, m->a->inv_mass));
+        ak_vec2_sub(m->a->velocity, AK_VEC2_MUL(impulse, m->a->inv_mass));
   if (!m->b->is_static)
     m->b->velocity =
-        ak_vec2_add(m->b->velocity, ak_vec2_mul(impulse, m->b->inv_mass));
+        ak_vec2_add(m->b->velocity, AK_VEC2_MUL(impulse, m->b->inv_mass));
 
   const ak_fixed_t percent = AK_INT_TO_FIXED(2) / 10; // 0.2
-  const ak_fixed_t slop = world->slop;
 
   ak_fixed_t correction_mag = AK_FIXED_MAX(AK_FIXED_SUB(m->depth, slop), 0);
   ak_fixed_t corr_num = AK_FIXED_MUL(correction_mag, percent);
   correction_mag = AK_FIXED_DIV(corr_num, den);
-  ak_vec2_t correction = ak_vec2_mul(m->normal, correction_mag);
+  ak_vec2_t correction = AK_VEC2_MUL(m->normal, correction_mag);
 
   if (!m->a->is_static)
     m->a->position =
-        ak_vec2_sub(m->a->position, ak_vec2_mul(correction, m->a->inv_mass));
+        ak_vec2_sub(m->a->position, AK_VEC2_MUL(correction, m->a->inv_mass));
   if (!m->b->is_static)
     m->b->position =
-        ak_vec2_add(m->b->position, ak_vec2_mul(correction, m->b->inv_mass));
+        ak_vec2_add(m->b->position, AK_VEC2_MUL(correction, m->b->inv_mass));
 }
 
-void ak_world_step(ak_world_t *world, ak_fixed_t dt) {
+static void ResolveCollision(ak_world_t *world, ak_manifold_t *m) {
+  ResolveContact(m, world->slop);
+}
+
+// --- Tilemap ---
+
+void ak_world_set_tilemap(ak_world_t *world, const uint8_t *tiles, int width,
+                          int height, ak_fixed_t tile_size, ak_vec2_t origin) {
+  ak_tilemap_t *map = &world->tilemap;
+  map->tiles = (tiles && width > 0 && height > 0 && tile_size > 0) ? tiles
+                                                                    : NULL;
+  map->width = width;
+  map->height = height;
+  map->tile_size = tile_size;
+  map->inv_tile_size = map->tiles ? AK_FIXED_DIV(AK_FIXED_ONE, tile_size) : 0;
+  map->origin = origin;
+  map->origin_tx = 0;
+  map->origin_ty = 0;
+  map->restitution = AK_FIXED_DIV(AK_INT_TO_FIXED(7), AK_INT_TO_FIXED(10));
+}
+
+// Tiles outside the map are empty, so the map's border faces are solid walls
+static int TileSolid(const ak_tilemap_t *map, int tx, int ty) {
+  if (tx < 0 || ty < 0 || tx >= map->width || ty >= map->height)
+    return 0;
+  return map->tiles[(int32_t)ty * map->width + tx] != 0;
+}
+
+// Body (A) against solid tile (tx, ty) (B). Faces whose neighbour tile is
+// also solid are internal seams and never produce a normal; the contact is
+// pushed out through the nearest open face instead.
+static ak_manifold_t SolveBodyTile(const ak_tilemap_t *map, ak_body_t *body,
+                                   ak_body_t *tile, int tx, int ty) {
+  ak_manifold_t m = {body, tile, {0, 0}, 0, 0};
+  ak_fixed_t half = map->tile_size / 2;
+  ak_vec2_t center = {
+      map->origin.x + map->tile_size * (tx - map->origin_tx) + half,
+      map->origin.y + map->tile_size * (ty - map->origin_ty) + half};
+  ak_vec2_t diff = ak_vec2_sub(body->position, center);
+
+  // Which tile face the body sits beyond, and whether that face is open
+  int side_x = diff.x < 0 ? -1 : 1;
+  int side_y = diff.y < 0 ? -1 : 1;
+  int open_x = !TileSolid(map, tx + side_x, ty);
+  int open_y = !TileSolid(map, tx, ty + side_y);
+  if (!open_x && !open_y)
+    return m;
+
+  // Normals run from the body to the tile
+  ak_vec2_t normal_x = {side_x > 0 ? -AK_FIXED_ONE : AK_FIXED_ONE, 0};
+  ak_vec2_t normal_y = {0, side_y > 0 ? -AK_FIXED_ONE : AK_FIXED_ONE};
+
+  if (body->shape.type == AK_SHAPE_CIRCLE) {
+    ak_fixed_t r = body->shape.bounds.circle.radius;
+    ak_fixed_t out_x = AK_FIXED_SUB(AK_FIXED_ABS(diff.x), half);
+    ak_fixed_t out_y = AK_FIXED_SUB(AK_FIXED_ABS(diff.y), half);
+
+    if (out_x > 0 && out_y > 0) {
+      // Nearest point is a corner
+      if (open_x && open_y) {
+        ak_vec2_t n = {side_x * out_x, side_y * out_y};
+        ak_fixed_t dist_sqr = AK_VEC2_LEN_SQR(n);
+        if (dist_sqr >= AK_FIXED_MUL(r, r))
+          return m;
+        ak_fixed_t dist = AK_FIXED_SQRT(dist_sqr);
+        if (dist == 0)
+          return m;
+        m.depth = AK_FIXED_SUB(r, dist);
+        m.normal = AK_VEC2_MUL(n, -AK_FIXED_DIV(AK_FIXED_ONE, dist));
+      } else if (open_x) {
+        // Corner on a continuous vertical wall: treat as the flat face
+        if (out_x >= r)
+          return m;
+        m.depth = AK_FIXED_SUB(r, out_x);
+        m.normal = normal_x;
+      } else {
+        if (out_y >= r)
+          return m;
+        m.depth = AK_FIXED_SUB(r, out_y);
+        m.normal = normal_y;
+      }
+    } else if (out_x > 0) {
+      if (!open_x || out_x >= r)
+        return m;
+      m.depth = AK_FIXED_SUB(r, out_x);
+      m.normal = normal_x;
+    } else if (out_y > 0) {
+      if (!open_y || out_y >= r)
+        return m;
+      m.depth = AK_FIXED_SUB(r, out_y);
+      m.normal = normal_y;
+    } else {
+      // Center inside the tile: leave through the shallowest open face
+      ak_fixed_t depth_x = AK_FIXED_ADD(r, -out_x);
+      ak_fixed_t depth_y = AK_FIXED_ADD(r, -out_y);
+      if (open_x && (!open_y || depth_x < depth_y)) {
+        m.depth = depth_x;
+        m.normal = normal_x;
+      } else {
+        m.depth = depth_y;
+        m.normal = normal_y;
+      }
+    }
+  } else {
+    ak_fixed_t x_overlap = AK_FIXED_SUB(
+        AK_FIXED_ADD(body->shape.bounds.aabb.width, half),
+        AK_FIXED_ABS(diff.x));
+    ak_fixed_t y_overlap = AK_FIXED_SUB(
+        AK_FIXED_ADD(body->shape.bounds.aabb.height, half),
+        AK_FIXED_ABS(diff.y));
+    if (x_overlap <= 0 || y_overlap <= 0)
+      return m;
+    if (open_x && (!open_y || x_overlap < y_overlap)) {
+      m.depth = x_overlap;
+      m.normal = normal_x;
+    } else {
+      m.depth = y_overlap;
+      m.normal = normal_y;
+    }
+  }
+
+  m.has_collision = 1;
+  return m;
+}
+
+// Half extents of a body's bounding box
+static void BodyExtents(const ak_body_t *b, ak_fixed_t *ex, ak_fixed_t *ey) {
+  if (b->shape.type == AK_SHAPE_CIRCLE) {
+    *ex = *ey = b->shape.bounds.circle.radius;
+  } else {
+    *ex = b->shape.bounds.aabb.width;
+    *ey = b->shape.bounds.aabb.height;
+  }
+}
+
+// Tiles overlapped by b's bounding box, clipped to the map. Returns 0 if
+// there are none.
+static int TileRange(const ak_tilemap_t *map, const ak_body_t *b, int *x0,
+                     int *y0, int *x1, int *y1) {
+  ak_fixed_t ex, ey;
+  BodyExtents(b, &ex, &ey);
+  ak_vec2_t rel = ak_vec2_sub(b->position, map->origin);
+
+  // Overlapped tile range (floor via arithmetic shift), clipped to the map
+  int32_t tx0 = AK_FIXED_TO_INT(AK_FIXED_MUL(rel.x - ex, map->inv_tile_size)) +
+                map->origin_tx;
+  int32_t tx1 = AK_FIXED_TO_INT(AK_FIXED_MUL(rel.x + ex, map->inv_tile_size)) +
+                map->origin_tx;
+  int32_t ty0 = AK_FIXED_TO_INT(AK_FIXED_MUL(rel.y - ey, map->inv_tile_size)) +
+                map->origin_ty;
+  int32_t ty1 = AK_FIXED_TO_INT(AK_FIXED_MUL(rel.y + ey, map->inv_tile_size)) +
+                map->origin_ty;
+  if (tx1 < 0 || ty1 < 0 || tx0 >= map->width || ty0 >= map->height)
+    return 0;
+  *x0 = tx0 < 0 ? 0 : (int)tx0;
+  *y0 = ty0 < 0 ? 0 : (int)ty0;
+  *x1 = tx1 >= map->width ? map->width - 1 : (int)tx1;
+  *y1 = ty1 >= map->height ? map->height - 1 : (int)ty1;
+  return 1;
+}
+
+static void CollideTilemap(ak_world_t *world, ak_body_t *b) {
+  const ak_tilemap_t *map = &world->tilemap;
+  int tx0, ty0, tx1, ty1;
+  if (!TileRange(map, b, &tx0, &ty0, &tx1, &ty1))
+    return;
+
+  // Every tile resolves against the same immovable proxy body
+  ak_body_t tile = {0};
+  tile.is_static = 1;
+  tile.restitution = map->restitution;
+
+  for (int ty = ty0; ty <= ty1; ty++) {
+    const uint8_t *row = map->tiles + (int32_t)ty * map->width;
+    for (int tx = tx0; tx <= tx1; tx++) {
+      if (!row[tx])
+        continue;
+      ak_manifold_t m = SolveBodyTile(map, b, &tile, tx, ty);
+      if (m.has_collision)
+        ResolveCollision(world, &m);
+    }
+  }
+}
+
+// --- Shared static geometry ---
+
+void ak_static_world_init(ak_static_world_t *statics) {
+  statics->body_count = 0;
+  statics->cols = 0;
+  statics->rows = 0;
+}
+
+ak_body_t *ak_static_world_add_body(ak_static_world_t *statics,
+                                    ak_shape_t shape, ak_fixed_t x,
+                                    ak_fixed_t y) {
+  if (statics->body_count >= AK_MAX_STATIC_BODIES)
+    return 0;
+  ak_body_t *b = &statics->bodies[statics->body_count++];
+  b->position = (ak_vec2_t){x, y};
+  b->velocity = (ak_vec2_t){0, 0};
+  b->force = (ak_vec2_t){0, 0};
+  b->shape = shape;
+  b->mass = 0;
+  b->inv_mass = 0;
+  b->restitution = AK_FIXED_DIV(AK_INT_TO_FIXED(7), AK_INT_TO_FIXED(10)); // 0.7
+  b->is_static = 1;
+  statics->cols = 0; // Index is stale until rebuilt
+  return b;
+}
+
+// Grid cell of an offset from the grid's top-left corner, clamped to the grid
+static int StaticCell(const ak_static_world_t *statics, ak_fixed_t rel,
+                      int count) {
+  int32_t c = AK_FIXED_TO_INT(AK_FIXED_MUL(rel, statics->inv_cell_size));
+  return c < 0 ? 0 : c >= count ? count - 1 : (int)c;
+}
+
+// Cells overlapped by the box lo..hi (which must overlap the bounds)
+static void StaticCellRange(const ak_static_world_t *statics, ak_vec2_t lo,
+                            ak_vec2_t hi, int *cx0, int *cy0, int *cx1,
+                            int *cy1) {
+  const ak_vec2_t *min = &statics->min;
+  *cx0 = StaticCell(statics, AK_FIXED_MAX(lo.x, min->x) - min->x,
+                    statics->cols);
+  *cy0 = StaticCell(statics, AK_FIXED_MAX(lo.y, min->y) - min->y,
+                    statics->rows);
+  *cx1 = StaticCell(statics, AK_FIXED_MIN(hi.x, statics->max.x) - min->x,
+                    statics->cols);
+  *cy1 = StaticCell(statics, AK_FIXED_MIN(hi.y, statics->max.y) - min->y,
+                    statics->rows);
+}
+
+int ak_static_world_build(ak_static_world_t *statics, ak_fixed_t cell_size) {
+  statics->cols = 0;
+  statics->rows = 0;
+  if (cell_size <= 0)
+    return 0;
+  if (statics->body_count == 0)
+    return 1;
+
+  // Bounds, in 64 bits until they are known to fit
+  int64_t x0 = INT64_MAX, y0 = INT64_MAX, x1 = INT64_MIN, y1 = INT64_MIN;
+  for (int i = 0; i < statics->body_count; i++) {
+    const ak_body_t *b = &statics->bodies[i];
+    ak_fixed_t ex, ey;
+    BodyExtents(b, &ex, &ey);
+    x0 = AK_FIXED_MIN(x0, (int64_t)b->position.x - ex);
+    y0 = AK_FIXED_MIN(y0, (int64_t)b->position.y - ey);
+    x1 = AK_FIXED_MAX(x1, (int64_t)b->position.x + ex);
+    y1 = AK_FIXED_MAX(y1, (int64_t)b->position.y + ey);
+  }
+  if (x0 < INT32_MIN || y0 < INT32_MIN || x1 > INT32_MAX || y1 > INT32_MAX ||
+      x1 - x0 > INT32_MAX || y1 - y0 > INT32_MAX)
+    return 0;
+
+  int64_t cols = (x1 - x0) / cell_size + 1;
+  int64_t rows = (y1 - y0) / cell_size + 1;
+  if (cols * rows > AK_MAX_STATIC_CELLS)
+    return 0;
+
+  statics->min = (ak_vec2_t){(ak_fixed_t)x0, (ak_fixed_t)y0};
+  statics->max = (ak_vec2_t){(ak_fixed_t)x1, (ak_fixed_t)y1};
+  statics->cell_size = cell_size;
+  statics->inv_cell_size = AK_FIXED_DIV(AK_FIXED_ONE, cell_size);
+  statics->cols = (int)cols;
+  statics->rows = (int)rows;
+  int cells = statics->cols * statics->rows;
+
+  // Counting sort of (cell, body) entries: count per cell, prefix sums, then
+  // fill in body order so each cell lists its bodies in ascending order
+  for (int c = 0; c <= cells; c++)
+    statics->cell_start[c] = 0;
+  int32_t refs = 0;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int i = 0; i < statics->body_count; i++) {
+      const ak_body_t *b = &statics->bodies[i];
+      ak_fixed_t ex, ey;
+      BodyExtents(b, &ex, &ey);
+      ak_vec2_t lo = {b->position.x - ex, b->position.y - ey};
+      ak_vec2_t hi = {b->position.x + ex, b->position.y + ey};
+      int cx0, cy0, cx1, cy1;
+      StaticCellRange(statics, lo, hi, &cx0, &cy0, &cx1, &cy1);
+      statics->first_col[i] = (uint16_t)cx0;
+      statics->first_row[i] = (uint16_t)cy0;
+      for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+          int c = cy * statics->cols + cx;
+          if (pass == 0) {
+            statics->cell_start[c + 1]++;
+            refs++;
+          } else {
+            statics->cell_bodies[statics->cell_start[c]++] = (uint16_t)i;
+          }
+        }
+      }
+    }
+    if (pass == 0) {
+      if (refs > AK_MAX_STATIC_REFS) {
+        statics->cols = 0;
+        statics->rows = 0;
+        return 0;
+      }
+      for (int c = 0; c < cells; c++)
+        statics->cell_start[c + 1] += statics->cell_start[c];
+    }
+  }
+  // Filling advanced each start to the next cell's; shift them back
+  for (int c = cells; c > 0; c--)
+    statics->cell_start[c] = statics->cell_start[c - 1];
+  statics->cell_start[0] = 0;
+  return 1;
+}
+
+void ak_world_set_static(ak_world_t *world, const ak_static_world_t *statics) {
+  world->statics = statics;
+}
+
+// --- Level of detail ---
+
+void ak_lod_init(ak_lod_t *lod, ak_fixed_t near_radius) {
+  lod->focus_count = 0;
+  for (int t = 0; t < AK_LOD_TIERS - 1; t++)
+    lod->radius[t] = near_radius << t;
+  lod->step = 0;
+  lod->body_count = 0;
+}
+
+void ak_world_set_lod(ak_world_t *world, ak_lod_t *lod) {
+  world->lod = lod;
+  if (lod)
+    lod->body_count = 0; // Nothing skipped yet
+}
+
+static ak_fixed_t Abs(ak_fixed_t v) { return v < 0 ? -v : v; }
+
+static int LodTier(const ak_lod_t *lod, const ak_body_t *b, ak_fixed_t dt) {
+  if (lod->focus_count == 0)
+    return 0;
+
+  // Per-axis distance to the nearest focus, in 64 bits so bodies on opposite
+  // sides of a large world do not overflow
+  int64_t d = INT64_MAX;
+  for (int f = 0; f < lod->focus_count; f++) {
+    int64_t dx = (int64_t)b->position.x - lod->foci[f].x;
+    int64_t dy = (int64_t)b->position.y - lod->foci[f].y;
+    dx = dx < 0 ? -dx : dx;
+    dy = dy < 0 ? -dy : dy;
+    if (dy > dx)
+      dx = dy;
+    if (dx < d)
+      d = dx;
+  }
+
+  // Measured from the nearest point the body could reach in the longest
+  // tier step
+  ak_fixed_t ex, ey;
+  BodyExtents(b, &ex, &ey);
+  ak_fixed_t speed = Abs(b->velocity.x) + Abs(b->velocity.y);
+  d -= (ex > ey ? ex : ey) +
+       (int64_t)AK_FIXED_MUL(speed, dt << (AK_LOD_TIERS - 1));
+
+  int t = 0;
+  while (t < AK_LOD_TIERS - 1 && d > lod->radius[t])
+    t++;
+  return t;
+}
+
+// Tiers and the bodies stepped this step
+static void LodBegin(ak_world_t *world, ak_fixed_t dt) {
+  ak_lod_t *lod = world->lod;
+  for (int i = lod->body_count; i < world->body_count; i++)
+    lod->owed[i] = 0; // Added since the last step
+  lod->body_count = world->body_count;
+  lod->step++;
+  for (int t = 0; t < AK_LOD_TIERS; t++)
+    lod->tier_counts[t] = 0;
+
+  for (int i = 0; i < world->body_count; i++) {
+    const ak_body_t *b = &world->bodies[i];
+    if (b->is_static) {
+      lod->active[i] = 0; // Only collides with bodies being stepped
+      continue;
+    }
+    int t = LodTier(lod, b, dt);
+    lod->tier[i] = (uint8_t)t;
+    lod->tier_counts[t]++;
+    // Tier t's phase is 2^(t-1), so no two far tiers share a step
+    uint32_t mask = (1u << t) - 1;
+    lod->active[i] = t == 0 || (lod->step & mask) == (mask + 1) / 2;
+    if (!lod->active[i] && lod->owed[i] < 255)
+      lod->owed[i]++;
+  }
+}
+
+// Whether a pair, tether or body-vs-geometry test runs this step
+#define AK_LOD_ACTIVE(lod, i) (!(lod) || (lod)->active[i])
+
+// --- Large worlds ---
+
+// The tilemap origin is kept this close to local (0, 0) by folding whole
+// tiles into origin_tx/ty, so maps of any size stay in 16.16 range
+#define AK_TILE_ORIGIN_LIMIT AK_INT_TO_FIXED(8192)
+
+static void ShiftTileOrigin(ak_fixed_t *origin, int32_t *origin_tile,
+                            ak_fixed_t shift, ak_fixed_t tile_size) {
+  int64_t o = (int64_t)*origin - shift;
+  if (o > AK_TILE_ORIGIN_LIMIT || o < -AK_TILE_ORIGIN_LIMIT) {
+    int64_t k = o / tile_size;
+    o -= k * tile_size;
+    *origin_tile -= (int32_t)k;
+  }
+  *origin = (ak_fixed_t)o;
+}
+
+void ak_world_shift_origin(ak_world_t *world, int32_t dx, int32_t dy) {
+  ak_vec2_t d = {AK_INT_TO_FIXED(dx), AK_INT_TO_FIXED(dy)};
+
+  for (int i = 0; i < world->body_count; i++)
+    world->bodies[i].position = ak_vec2_sub(world->bodies[i].position, d);
+  for (int i = 0; i < world->rope_node_count; i++)
+    world->rope_nodes[i].position =
+        ak_vec2_sub(world->rope_nodes[i].position, d);
+
+  ak_tilemap_t *map = &world->tilemap;
+  if (map->tiles) {
+    ShiftTileOrigin(&map->origin.x, &map->origin_tx, d.x, map->tile_size);
+    ShiftTileOrigin(&map->origin.y, &map->origin_ty, d.y, map->tile_size);
+  }
+
+  world->origin_x += dx;
+  world->origin_y += dy;
+}
+
+int ak_world_recenter(ak_world_t *world, ak_vec2_t focus, int32_t *dx,
+                      int32_t *dy) {
+  const ak_fixed_t limit = AK_INT_TO_FIXED(AK_RECENTER_DISTANCE);
+  if (AK_FIXED_ABS(focus.x) <= limit && AK_FIXED_ABS(focus.y) <= limit)
+    return 0;
+
+  int32_t sx = AK_FIXED_TO_INT(focus.x);
+  int32_t sy = AK_FIXED_TO_INT(focus.y);
+  ak_world_shift_origin(world, sx, sy);
+  if (dx)
+    *dx = sx;
+  if (dy)
+    *dy = sy;
+  return 1;
+}
+
+ak_gvec2_t ak_world_to_global(const ak_world_t *world, ak_vec2_t local) {
+  ak_gvec2_t g = {(int64_t)world->origin_x * AK_FIXED_ONE + local.x,
+                  (int64_t)world->origin_y * AK_FIXED_ONE + local.y};
+  return g;
+}
+
+ak_vec2_t ak_world_to_local(const ak_world_t *world, ak_gvec2_t global) {
+  ak_vec2_t l = {
+      (ak_fixed_t)(global.x - (int64_t)world->origin_x * AK_FIXED_ONE),
+      (ak_fixed_t)(global.y - (int64_t)world->origin_y * AK_FIXED_ONE)};
+  return l;
+}
+
+// --- Stepping ---
+
+// Shared by the generic and specialized steps. The flags are compile-time
+// constants in the variants, so forced inlining folds the dead branches away.
+#if defined(__GNUC__)
+#define AK_FORCE_INLINE static inline __attribute__((always_inline))
+#else
+#define AK_FORCE_INLINE static inline
+#endif
+
+AK_FORCE_INLINE void IntegrateBody(const ak_world_t *world, ak_body_t *b,
+                                   ak_fixed_t dt) {
+  // Apply gravity
+  b->force = ak_vec2_add(
+      b->force,
+      AK_VEC2_MUL(world->gravity, AK_FIXED_DIV(AK_FIXED_ONE, b->inv_mass)));
+
+  // Integrate Velocity
+  ak_vec2_t acceleration = AK_VEC2_MUL(b->force, b->inv_mass);
+  b->velocity = ak_vec2_add(b->velocity, AK_VEC2_MUL(acceleration, dt));
+
+  // Integrate Position
+  b->position = ak_vec2_add(b->position, AK_VEC2_MUL(b->velocity, dt));
+
+  // Reset force
+  b->force = (ak_vec2_t){0, 0};
+}
+
+AK_FORCE_INLINE void IntegrateBodies(ak_world_t *world, ak_fixed_t step_dt,
+                                     int has_static) {
+  ak_lod_t *lod = world->lod;
+  if (lod)
+    LodBegin(world, step_dt);
+
   for (int i = 0; i < world->body_count; i++) {
     ak_body_t *b = &world->bodies[i];
-    if (b->is_static)
+    if (has_static && b->is_static)
       continue;
 
-    // Apply gravity
-    b->force = ak_vec2_add(
-        b->force,
-        ak_vec2_mul(world->gravity, AK_FIXED_DIV(AK_FIXED_ONE, b->inv_mass)));
+    // Far bodies integrate over every step they skipped
+    ak_fixed_t dt = step_dt;
+    if (lod) {
+      if (!lod->active[i])
+        continue;
+      dt = step_dt * (lod->owed[i] + 1);
+      lod->owed[i] = 0;
+    }
+    IntegrateBody(world, b, dt);
+  }
+}
 
-    // Integrate Velocity
-    ak_vec2_t acceleration = ak_vec2_mul(b->force, b->inv_mass);
-    b->velocity = ak_vec2_add(b->velocity, ak_vec2_mul(acceleration, dt));
+// Narrowphase for any shape pair; the normal runs from a to b
+AK_FORCE_INLINE ak_manifold_t SolvePair(ak_body_t *a, ak_body_t *b) {
+  ak_manifold_t m = {0};
+
+  if (a->shape.type == AK_SHAPE_CIRCLE && b->shape.type == AK_SHAPE_CIRCLE) {
+    m = SolveCircleCircle(a, b);
+  } else if (a->shape.type == AK_SHAPE_AABB &&
+             b->shape.type == AK_SHAPE_AABB) {
+    m = SolveAABBAABB(a, b);
+  } else if (a->shape.type == AK_SHAPE_CIRCLE &&
+             b->shape.type == AK_SHAPE_AABB) {
+    m = SolveCircleAABB(a, b);
+  } else if (a->shape.type == AK_SHAPE_AABB &&
+             b->shape.type == AK_SHAPE_CIRCLE) {
+    m = SolveCircleAABB(b, a);
+    m.normal = AK_VEC2_MUL(m.normal, -AK_FIXED_ONE);
+    m.a = a;
+    m.b = b;
+  }
+  return m;
+}
 
-    // Integrate Position
-    b->position = ak_vec2_add(b->position, ak_vec2_mul(b->velocity, dt));
+AK_FORCE_INLINE void CollidePair(ak_world_t *world, ak_body_t *a, ak_body_t *b,
+                                 int has_static) {
+  if (has_static && a->is_static && b->is_static)
+    return;
 
-    // Reset force
-    b->force = (ak_vec2_t){0, 0};
+  ak_manifold_t m = SolvePair(a, b);
+  if (m.has_collision) {
+    ResolveCollision(world, &m);
   }
+}
+
+static void CollideStatics(ak_world_t *world, ak_body_t *b) {
+  const ak_static_world_t *sw = world->statics;
+
+  ak_fixed_t ex, ey;
+  BodyExtents(b, &ex, &ey);
+  ak_vec2_t lo = {b->position.x - ex, b->position.y - ey};
+  ak_vec2_t hi = {b->position.x + ex, b->position.y + ey};
+  if (hi.x < sw->min.x || hi.y < sw->min.y || lo.x > sw->max.x ||
+      lo.y > sw->max.y)
+    return;
+
+  int cx0, cy0, cx1, cy1;
+  StaticCellRange(sw, lo, hi, &cx0, &cy0, &cx1, &cy1);
+  for (int cy = cy0; cy <= cy1; cy++) {
+    for (int cx = cx0; cx <= cx1; cx++) {
+      int c = cy * sw->cols + cx;
+      for (int k = sw->cell_start[c]; k < sw->cell_start[c + 1]; k++) {
+        int i = sw->cell_bodies[k];
+        // A body listed in several overlapped cells is tested once, in the
+        // top-left cell of the overlap
+        if ((cx != cx0 && cx != sw->first_col[i]) ||
+            (cy != cy0 && cy != sw->first_row[i]))
+          continue;
+        // Static bodies are never written by the solver
+        CollidePair(world, b, (ak_body_t *)&sw->bodies[i], 1);
+      }
+    }
+  }
+}
+
+void ak_world_step_begin(ak_world_t *world, ak_fixed_t dt) {
+  if (world->commands)
+    ak_commands_apply(world->commands, world);
+  SortIfDue(world);
+
+  AK_OPS_PHASE(AK_PHASE_INTEGRATE);
+  IntegrateBodies(world, dt, 1);
+  AK_OPS_PHASE(AK_PHASE_OTHER);
+
+  world->step.phase = AK_STEP_PAIRS;
+  world->step.i = 0;
+  world->step.j = 1;
+  world->step.dt = dt;
+  world->step.work = 0;
+}
+
+// Out of budget: leave the step where it is for the next call
+static int Yield(ak_step_state_t *st, int32_t work) {
+  st->work += work;
+  AK_OPS_PHASE(AK_PHASE_OTHER);
+  return 0;
+}
+
+int ak_world_step_continue(ak_world_t *world, int32_t max_work_units) {
+  ak_step_state_t *st = &world->step;
+  int32_t work = 0;
 
   // Collisions
+  AK_OPS_PHASE(AK_PHASE_PAIRS);
+  while (st->phase == AK_STEP_PAIRS) {
+    if (st->j >= world->body_count) {
+      if (++st->i >= world->body_count) {
+        st->phase = AK_STEP_STATICS;
+        st->i = 0;
+        break;
+      }
+      st->j = st->i + 1;
+      continue;
+    }
+    if (!AK_LOD_ACTIVE(world->lod, st->i) &&
+        !AK_LOD_ACTIVE(world->lod, st->j)) {
+      st->j++; // Neither is being stepped
+      continue;
+    }
+    if (work >= max_work_units)
+      return Yield(st, work);
+    CollidePair(world, &world->bodies[st->i], &world->bodies[st->j], 1);
+    st->j++;
+    work++;
+  }
+
+  // Shared static geometry
+  AK_OPS_PHASE(AK_PHASE_STATICS);
+  while (st->phase == AK_STEP_STATICS) {
+    if (!world->statics || !world->statics->cols ||
+        st->i >= world->body_count) {
+      st->phase = AK_STEP_TILEMAP;
+      st->i = 0;
+      break;
+    }
+    ak_body_t *b = &world->bodies[st->i];
+    if (!b->is_static && AK_LOD_ACTIVE(world->lod, st->i)) {
+      if (work >= max_work_units)
+        return Yield(st, work);
+      CollideStatics(world, b);
+      work++;
+    }
+    st->i++;
+  }
+
+  // Level geometry
+  AK_OPS_PHASE(AK_PHASE_TILEMAP);
+  while (st->phase == AK_STEP_TILEMAP) {
+    if (!world->tilemap.tiles || st->i >= world->body_count) {
+      st->phase = AK_STEP_TETHERS;
+      st->i = 0;
+      break;
+    }
+    ak_body_t *b = &world->bodies[st->i];
+    if (!b->is_static && AK_LOD_ACTIVE(world->lod, st->i)) {
+      if (work >= max_work_units)
+        return Yield(st, work);
+      CollideTilemap(world, b);
+      work++;
+    }
+    st->i++;
+  }
+
+  // Tethers
+  AK_OPS_PHASE(AK_PHASE_TETHERS);
+  while (st->phase == AK_STEP_TETHERS) {
+    if (st->i >= world->tether_count) {
+      st->phase = AK_STEP_ROPES;
+      st->i = 0;
+      break;
+    }
+    ak_tether_t *t = &world->tethers[st->i];
+    if (!AK_LOD_ACTIVE(world->lod, t->a) && !AK_LOD_ACTIVE(world->lod, t->b)) {
+      st->i++;
+      continue;
+    }
+    if (work >= max_work_units)
+      return Yield(st, work);
+    ResolveTether(world, t);
+    st->i++;
+    work++;
+  }
+
+  // Ropes. A rope is never split, so a call can overshoot its budget by one
+  // rope's links * iterations.
+  AK_OPS_PHASE(AK_PHASE_ROPES);
+  while (st->phase == AK_STEP_ROPES) {
+    if (st->i >= world->rope_count) {
+      st->phase = AK_STEP_DONE;
+      break;
+    }
+    if (work >= max_work_units)
+      return Yield(st, work);
+    ak_rope_t *rope = &world->ropes[st->i++];
+    ResolveRope(world, rope, st->dt);
+    work += (int32_t)(rope->node_count - 1) * rope->iterations;
+  }
+
+  st->work += work;
+  AK_OPS_PHASE(AK_PHASE_OTHER);
+  return st->phase == AK_STEP_DONE;
+}
+
+void ak_world_step_end(ak_world_t *world) {
+  ak_world_step_continue(world, AK_STEP_UNLIMITED);
+  world->step.phase = AK_STEP_IDLE;
+}
+
+void ak_world_step(ak_world_t *world, ak_fixed_t dt) {
+  ak_world_step_begin(world, dt);
+  ak_world_step_end(world);
+}
+
+// --- Prediction ---
+
+// First shared static body b overlaps, 0 if none
+static const ak_body_t *TouchStatics(const ak_static_world_t *sw, ak_body_t *b,
+                                     ak_manifold_t *m) {
+  ak_fixed_t ex, ey;
+  BodyExtents(b, &ex, &ey);
+  ak_vec2_t lo = {b->position.x - ex, b->position.y - ey};
+  ak_vec2_t hi = {b->position.x + ex, b->position.y + ey};
+  if (hi.x < sw->min.x || hi.y < sw->min.y || lo.x > sw->max.x ||
+      lo.y > sw->max.y)
+    return 0;
+
+  int cx0, cy0, cx1, cy1;
+  StaticCellRange(sw, lo, hi, &cx0, &cy0, &cx1, &cy1);
+  for (int cy = cy0; cy <= cy1; cy++) {
+    for (int cx = cx0; cx <= cx1; cx++) {
+      int c = cy * sw->cols + cx;
+      for (int k = sw->cell_start[c]; k < sw->cell_start[c + 1]; k++) {
+        const ak_body_t *s = &sw->bodies[sw->cell_bodies[k]];
+        *m = SolvePair(b, (ak_body_t *)s);
+        if (m->has_collision)
+          return s;
+      }
+    }
+  }
+  return 0;
+}
+
+// Whether b overlaps a solid tile, with the contact in *m
+static int TouchTilemap(const ak_tilemap_t *map, ak_body_t *b,
+                        ak_manifold_t *m) {
+  int tx0, ty0, tx1, ty1;
+  if (!TileRange(map, b, &tx0, &ty0, &tx1, &ty1))
+    return 0;
+  ak_body_t tile = {0};
+  for (int ty = ty0; ty <= ty1; ty++) {
+    const uint8_t *row = map->tiles + (int32_t)ty * map->width;
+    for (int tx = tx0; tx <= tx1; tx++) {
+      if (!row[tx])
+        continue;
+      *m = SolveBodyTile(map, b, &tile, tx, ty);
+      if (m->has_collision)
+        return 1;
+    }
+  }
+  return 0;
+}
+
+int ak_predict_trajectory(const ak_world_t *world, const ak_body_t *body,
+                          ak_fixed_t dt, int steps, ak_vec2_t *out_points,
+                          ak_contact_t *contact) {
+  if (contact) {
+    contact->body_a_id = body->id;
+    contact->body_b_id = AK_CONTACT_NONE;
+    contact->normal = (ak_vec2_t){0, 0};
+  }
+  if (body->is_static)
+    return 0;
+
+  ak_body_t b = *body;
+  for (int n = 0; n < steps;) {
+    IntegrateBody(world, &b, dt);
+    out_points[n++] = b.position;
+
+    // Everything else stays where it is; solvers only read the other body
+    ak_manifold_t m = {0};
+    int hit_id = AK_CONTACT_NONE;
+    for (int i = 0; i < world->body_count; i++) {
+      ak_body_t *other = (ak_body_t *)&world->bodies[i];
+      if (other == body)
+        continue;
+      m = SolvePair(&b, other);
+      if (m.has_collision) {
+        hit_id = other->id;
+        break;
+      }
+    }
+    if (hit_id == AK_CONTACT_NONE && world->statics && world->statics->cols) {
+      const ak_body_t *s = TouchStatics(world->statics, &b, &m);
+      if (s)
+        hit_id = s->id;
+    }
+    if (hit_id == AK_CONTACT_NONE && world->tilemap.tiles &&
+        TouchTilemap(&world->tilemap, &b, &m))
+      hit_id = AK_CONTACT_TILE;
+
+    if (hit_id != AK_CONTACT_NONE) {
+      if (contact) {
+        contact->body_b_id = hit_id;
+        contact->normal = m.normal;
+      }
+      return n;
+    }
+  }
+  return steps;
+}
+
+// --- Specialized steps ---
+
+AK_FORCE_INLINE void StepKernel(ak_world_t *world, ak_fixed_t dt, int shapes,
+                                int has_static, int has_tethers) {
+  if (world->commands)
+    ak_commands_apply(world->commands, world);
+  SortIfDue(world);
+
+  AK_OPS_PHASE(AK_PHASE_INTEGRATE);
+  IntegrateBodies(world, dt, has_static);
+
+  // Collisions
+  AK_OPS_PHASE(AK_PHASE_PAIRS);
+  const ak_lod_t *lod = world->lod;
   for (int i = 0; i < world->body_count; i++) {
+    ak_body_t *a = &world->bodies[i];
+    int a_active = AK_LOD_ACTIVE(lod, i);
     for (int j = i + 1; j < world->body_count; j++) {
-      ak_manifold_t m = {0};
-      ak_body_t *a = &world->bodies[i];
       ak_body_t *b = &world->bodies[j];
-
-      if (a->is_static && b->is_static)
+      if (!a_active && !AK_LOD_ACTIVE(lod, j))
+        continue;
+      if (shapes == AK_STEP_SHAPES_ANY) {
+        CollidePair(world, a, b, has_static);
         continue;
+      }
+      if (has_static && a->is_static && b->is_static)
+        continue;
+      ak_manifold_t m = (shapes == AK_STEP_SHAPES_CIRCLE)
+                            ? SolveCircleCircle(a, b)
+                            : SolveAABBAABB(a, b);
+      if (m.has_collision)
+        ResolveCollision(world, &m);
+    }
+  }
+
+  // Shared static geometry. Its shapes are not covered by the variant's
+  // shape subset, so pairs go through the generic dispatch.
+  AK_OPS_PHASE(AK_PHASE_STATICS);
+  if (world->statics && world->statics->cols) {
+    for (int i = 0; i < world->body_count; i++) {
+      ak_body_t *b = &world->bodies[i];
+      if ((!has_static || !b->is_static) && AK_LOD_ACTIVE(lod, i))
+        CollideStatics(world, b);
+    }
+  }
+
+  // Level geometry
+  AK_OPS_PHASE(AK_PHASE_TILEMAP);
+  if (world->tilemap.tiles) {
+    for (int i = 0; i < world->body_count; i++) {
+      ak_body_t *b = &world->bodies[i];
+      if ((!has_static || !b->is_static) && AK_LOD_ACTIVE(lod, i))
+        CollideTilemap(world, b);
+    }
+  }
+
+  AK_OPS_PHASE(AK_PHASE_TETHERS);
+  if (has_tethers) {
+    for (int i = 0; i < world->tether_count; i++) {
+      ak_tether_t *t = &world->tethers[i];
+      if (AK_LOD_ACTIVE(lod, t->a) || AK_LOD_ACTIVE(lod, t->b))
+        ResolveTether(world, t);
+    }
+  }
+
+  AK_OPS_PHASE(AK_PHASE_ROPES);
+  for (int i = 0; i < world->rope_count; i++)
+    ResolveRope(world, &world->ropes[i], dt);
+  AK_OPS_PHASE(AK_PHASE_OTHER);
+}
+
+#define AK_DEFINE_STEP_VARIANT(name, shapes, has_static, has_tethers)          \
+  void ak_world_step_##name(ak_world_t *world, ak_fixed_t dt) {                \
+    StepKernel(world, dt, shapes, has_static, has_tethers);                    \
+  }
+AK_STEP_VARIANTS(AK_DEFINE_STEP_VARIANT)
+
+// --- World packs ---
+
+int ak_world_pack_load(ak_world_pack_t *pack, const ak_world_t *const *worlds,
+                       int count) {
+  if (count < 1 || count > AK_PACK_LANES)
+    return 0;
+  const ak_world_t *w0 = worlds[0];
+  for (int k = 0; k < count; k++) {
+    const ak_world_t *w = worlds[k];
+    if (w->step.phase != AK_STEP_IDLE || w->rope_count || w->tilemap.tiles ||
+        w->statics || w->lod || w->commands || w->sort_interval)
+      return 0;
+    if (w->body_count != w0->body_count || w->tether_count != w0->tether_count)
+      return 0;
+    for (int i = 0; i < w->body_count; i++) {
+      if (w->bodies[i].shape.type != w0->bodies[i].shape.type ||
+          !w->bodies[i].is_static != !w0->bodies[i].is_static)
+        return 0;
+    }
+    for (int i = 0; i < w->tether_count; i++) {
+      if (w->tethers[i].a != w0->tethers[i].a ||
+          w->tethers[i].b != w0->tethers[i].b)
+        return 0;
+    }
+  }
+
+  pack->world_count = count;
+  pack->body_count = w0->body_count;
+  pack->tether_count = w0->tether_count;
+  for (int i = 0; i < w0->body_count; i++) {
+    pack->shape[i] = (uint8_t)w0->bodies[i].shape.type;
+    pack->is_static[i] = w0->bodies[i].is_static != 0;
+  }
+  for (int i = 0; i < w0->tether_count; i++) {
+    pack->tethers[i].a = w0->tethers[i].a;
+    pack->tethers[i].b = w0->tethers[i].b;
+  }
 
-      if (a->shape.type == AK_SHAPE_CIRCLE &&
-          b->shape.type == AK_SHAPE_CIRCLE) {
-        m = SolveCircleCircle(a, b);
-      } else if (a->shape.type == AK_SHAPE_AABB &&
-                 b->shape.type == AK_SHAPE_AABB) {
-        m = SolveAABBAABB(a, b);
-      } else if (a->shape.type == AK_SHAPE_CIRCLE &&
-                 b->shape.type == AK_SHAPE_AABB) {
-        m = SolveCircleAABB(a, b);
-      } else if (a->shape.type == AK_SHAPE_AABB &&
-                 b->shape.type == AK_SHAPE_CIRCLE) {
-        m = SolveCircleAABB(b, a);
-        m.normal = ak_vec2_mul(m.normal, -AK_FIXED_ONE);
-        m.a = a;
-        m.b = b;
+  // Spare lanes repeat lane 0 so their math stays well defined
+  for (int l = 0; l < AK_PACK_LANES; l++) {
+    const ak_world_t *w = worlds[l < count ? l : 0];
+    pack->gx[l] = w->gravity.x;
+    pack->gy[l] = w->gravity.y;
+    pack->slop[l] = w->slop;
+    pack->max_correction[l] = w->max_correction;
+    for (int i = 0; i < w->body_count; i++) {
+      const ak_body_t *b = &w->bodies[i];
+      ak_pack_body_t *p = &pack->bodies[i];
+      p->px[l] = b->position.x;
+      p->py[l] = b->position.y;
+      p->vx[l] = b->velocity.x;
+      p->vy[l] = b->velocity.y;
+      p->fx[l] = b->force.x;
+      p->fy[l] = b->force.y;
+      p->inv_mass[l] = b->inv_mass;
+      p->gravity_mass[l] =
+          b->is_static ? 0 : AK_FIXED_DIV(AK_FIXED_ONE, b->inv_mass);
+      p->restitution[l] = b->restitution;
+      if (b->shape.type == AK_SHAPE_CIRCLE) {
+        p->ex[l] = p->ey[l] = b->shape.bounds.circle.radius;
+      } else {
+        p->ex[l] = b->shape.bounds.aabb.width;
+        p->ey[l] = b->shape.bounds.aabb.height;
       }
+    }
+    for (int i = 0; i < w->tether_count; i++) {
+      pack->tethers[i].max_length[l] = w->tethers[i].max_length;
+      pack->tethers[i].max_length_sqr[l] = w->tethers[i].max_length_sqr;
+    }
+  }
+  return 1;
+}
 
-      if (m.has_collision) {
-        ResolveCollision(world, &m);
+int ak_world_pack_store(const ak_world_pack_t *pack, int lane,
+                        ak_world_t *world) {
+  if (lane < 0 || lane >= AK_PACK_LANES ||
+      world->body_count != pack->body_count)
+    return 0;
+  for (int i = 0; i < pack->body_count; i++) {
+    const ak_pack_body_t *p = &pack->bodies[i];
+    ak_body_t *b = &world->bodies[i];
+    b->position = (ak_vec2_t){p->px[lane], p->py[lane]};
+    b->velocity = (ak_vec2_t){p->vx[lane], p->vy[lane]};
+    b->force = (ak_vec2_t){p->fx[lane], p->fy[lane]};
+  }
+  return 1;
+}
+
+// One lane of body i as the scalar solvers see it
+static void PackGather(const ak_world_pack_t *pack, int i, int l,
+                       ak_body_t *b) {
+  const ak_pack_body_t *p = &pack->bodies[i];
+  b->position = (ak_vec2_t){p->px[l], p->py[l]};
+  b->velocity = (ak_vec2_t){p->vx[l], p->vy[l]};
+  b->inv_mass = p->inv_mass[l];
+  b->restitution = p->restitution[l];
+  b->is_static = pack->is_static[i];
+  b->shape.type = (ak_shape_type_t)pack->shape[i];
+  if (b->shape.type == AK_SHAPE_CIRCLE) {
+    b->shape.bounds.circle.radius = p->ex[l];
+  } else {
+    b->shape.bounds.aabb.width = p->ex[l];
+    b->shape.bounds.aabb.height = p->ey[l];
+  }
+}
+
+static void PackScatter(ak_world_pack_t *pack, int i, int l,
+                        const ak_body_t *b) {
+  ak_pack_body_t *p = &pack->bodies[i];
+  p->px[l] = b->position.x;
+  p->py[l] = b->position.y;
+  p->vx[l] = b->velocity.x;
+  p->vy[l] = b->velocity.y;
+}
+
+// Sets near[l] for the lanes where bodies i and j may touch; returns whether
+// any do. AABB pairs use the solver's own overlap test. Circle tests reject
+// only beyond a box one unit larger than the radius, where the solver's
+// squared distance is certain to exceed the squared radius as well.
+static int PackNear(const ak_world_pack_t *pack, int i, int j, uint8_t *near) {
+  const ak_pack_body_t *a = &pack->bodies[i];
+  const ak_pack_body_t *b = &pack->bodies[j];
+  int circle_a = pack->shape[i] == AK_SHAPE_CIRCLE;
+  int circle_b = pack->shape[j] == AK_SHAPE_CIRCLE;
+  int any = 0;
+
+  if (!circle_a && !circle_b) {
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      ak_fixed_t nx = AK_FIXED_ABS(b->px[l] - a->px[l]);
+      ak_fixed_t ny = AK_FIXED_ABS(b->py[l] - a->py[l]);
+      near[l] = (a->ex[l] + b->ex[l] - nx > 0) & (a->ey[l] + b->ey[l] - ny > 0);
+    }
+  } else if (circle_a && circle_b) {
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      ak_fixed_t reach = a->ex[l] + b->ex[l] + AK_FIXED_ONE;
+      ak_fixed_t nx = AK_FIXED_ABS(b->px[l] - a->px[l]);
+      ak_fixed_t ny = AK_FIXED_ABS(b->py[l] - a->py[l]);
+      near[l] = (nx < reach) & (ny < reach);
+    }
+  } else {
+    const ak_pack_body_t *c = circle_a ? a : b;
+    const ak_pack_body_t *box = circle_a ? b : a;
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      ak_fixed_t dx = c->px[l] - box->px[l];
+      ak_fixed_t dy = c->py[l] - box->py[l];
+      ak_fixed_t cx = AK_FIXED_MAX(-box->ex[l], AK_FIXED_MIN(box->ex[l], dx));
+      ak_fixed_t cy = AK_FIXED_MAX(-box->ey[l], AK_FIXED_MIN(box->ey[l], dy));
+      ak_fixed_t reach = c->ex[l] + AK_FIXED_ONE;
+      ak_fixed_t nx = AK_FIXED_ABS(dx - cx);
+      ak_fixed_t ny = AK_FIXED_ABS(dy - cy);
+      near[l] = (nx < reach) & (ny < reach);
+    }
+  }
+  for (int l = 0; l < AK_PACK_LANES; l++)
+    any |= near[l];
+  return any;
+}
+
+void ak_world_pack_step(ak_world_pack_t *pack, ak_fixed_t dt) {
+  int n = pack->body_count;
+
+  // Integrate, as IntegrateBody does for each lane
+  AK_OPS_PHASE(AK_PHASE_INTEGRATE);
+  for (int i = 0; i < n; i++) {
+    if (pack->is_static[i])
+      continue;
+    ak_pack_body_t *p = &pack->bodies[i];
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      ak_fixed_t fx = AK_FIXED_ADD(p->fx[l],
+                                   AK_FIXED_MUL(pack->gx[l], p->gravity_mass[l]));
+      ak_fixed_t fy = AK_FIXED_ADD(p->fy[l],
+                                   AK_FIXED_MUL(pack->gy[l], p->gravity_mass[l]));
+      ak_fixed_t ax = AK_FIXED_MUL(fx, p->inv_mass[l]);
+      ak_fixed_t ay = AK_FIXED_MUL(fy, p->inv_mass[l]);
+      p->vx[l] = AK_FIXED_ADD(p->vx[l], AK_FIXED_MUL(ax, dt));
+      p->vy[l] = AK_FIXED_ADD(p->vy[l], AK_FIXED_MUL(ay, dt));
+      p->px[l] = AK_FIXED_ADD(p->px[l], AK_FIXED_MUL(p->vx[l], dt));
+      p->py[l] = AK_FIXED_ADD(p->py[l], AK_FIXED_MUL(p->vy[l], dt));
+      p->fx[l] = p->fy[l] = 0;
+    }
+  }
+
+  // Collisions, in the same pair order as the scalar step
+  AK_OPS_PHASE(AK_PHASE_PAIRS);
+  uint8_t near[AK_PACK_LANES];
+  for (int i = 0; i < n; i++) {
+    for (int j = i + 1; j < n; j++) {
+      if ((pack->is_static[i] && pack->is_static[j]) ||
+          !PackNear(pack, i, j, near))
+        continue;
+      for (int l = 0; l < AK_PACK_LANES; l++) {
+        if (!near[l])
+          continue;
+        ak_body_t a, b;
+        PackGather(pack, i, l, &a);
+        PackGather(pack, j, l, &b);
+        ak_manifold_t m = SolvePair(&a, &b);
+        if (!m.has_collision)
+          continue;
+        ResolveContact(&m, pack->slop[l]);
+        PackScatter(pack, i, l, &a);
+        PackScatter(pack, j, l, &b);
       }
     }
   }
 
-  // Tethers
-  ResolveTethers(world);
+  // Tethers: the slack test of ResolveTetherBodies for every lane, then the
+  // scalar solve for the taut ones
+  AK_OPS_PHASE(AK_PHASE_TETHERS);
+  for (int k = 0; k < pack->tether_count; k++) {
+    const ak_pack_tether_t *t = &pack->tethers[k];
+    const ak_pack_body_t *pa = &pack->bodies[t->a];
+    const ak_pack_body_t *pb = &pack->bodies[t->b];
+    uint8_t taut[AK_PACK_LANES];
+    int any = 0;
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      const ak_fixed_t limit = 8000000; // As in ak_vec2_len_sqr
+      ak_fixed_t dx = pb->px[l] - pa->px[l];
+      ak_fixed_t dy = pb->py[l] - pa->py[l];
+      ak_fixed_t len = t->max_length[l];
+      int big = (dx > limit) | (dx < -limit) | (dy > limit) | (dy < -limit);
+      ak_fixed_t d2 = big ? 2147483647
+                          : AK_FIXED_ADD(AK_FIXED_MUL(dx, dx),
+                                         AK_FIXED_MUL(dy, dy));
+      int slack = (t->max_length_sqr[l] != 0) & (AK_FIXED_ABS(dx) <= len) &
+                  (AK_FIXED_ABS(dy) <= len) & (d2 <= t->max_length_sqr[l]);
+      taut[l] = (uint8_t)!slack;
+      any |= !slack;
+    }
+    if (!any)
+      continue;
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      if (!taut[l])
+        continue;
+      ak_tether_t scalar = {t->a, t->b, t->max_length[l],
+                            t->max_length_sqr[l]};
+      ak_body_t a, b;
+      PackGather(pack, t->a, l, &a);
+      PackGather(pack, t->b, l, &b);
+      ResolveTetherBodies(&scalar, &a, &b, pack->max_correction[l]);
+      PackScatter(pack, t->a, l, &a);
+      PackScatter(pack, t->b, l, &b);
+    }
+  }
+  AK_OPS_PHASE(AK_PHASE_OTHER);
 }
@@ -11,6 +11,25 @@
 #define AK_MAX_TETHERS 16
 #endif
 
+#ifndef AK_MAX_ROPES
+#define AK_MAX_ROPES 4
+#endif
+
+// Rope nodes are shared by all ropes in a world (contiguous per rope).
+#ifndef AK_MAX_ROPE_NODES
+#define AK_MAX_ROPE_NODES 128
+#endif
+
+// Distance (px) from the local origin at which ak_world_recenter moves it
+#ifndef AK_RECENTER_DISTANCE
+#define AK_RECENTER_DISTANCE 4096
+#endif
+
+// Default constraint iterations per step for new ropes
+#ifndef AK_ROPE_ITERATIONS
+#define AK_ROPE_ITERATIONS 4
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -19,6 +38,12 @@ typedef struct {
   ak_fixed_t x, y;
 } ak_vec2_t;
 
+// A global position: 16.16 in 64 bits, for worlds beyond the +/-32k px that
+// ak_vec2_t can hold. The solver never sees these (see ak_world_shift_origin).
+typedef struct {
+  int64_t x, y;
+} ak_gvec2_t;
+
 typedef enum { AK_SHAPE_CIRCLE, AK_SHAPE_AABB } ak_shape_type_t;
 
 typedef struct {
@@ -34,7 +59,7 @@ typedef struct {
 } ak_shape_t;
 
 typedef struct {
-  int id;
+  int id; // Assigned by the caller; 0 (none) when added
   ak_vec2_t position;
   ak_vec2_t velocity;
   ak_vec2_t force;
@@ -49,17 +74,129 @@ typedef struct {
 } ak_body_t;
 
 typedef struct {
-  ak_body_t *a;
-  ak_body_t *b;
-  ak_fixed_t max_length_sqr;
+  int a; // Body indices into world->bodies
+  int b;
+  ak_fixed_t max_length;
+  ak_fixed_t max_length_sqr; // 0 if too long for a 32-bit squared check
 } ak_tether_t;
 
+// A point mass in a rope. Nodes do not collide; they only obey the rope's
+// distance constraints, gravity and their end attachments.
+typedef struct {
+  ak_vec2_t position;
+  ak_vec2_t velocity;
+} ak_rope_node_t;
+
+typedef struct {
+  int first_node; // Index into world->rope_nodes
+  int node_count;
+  int body_a; // Body index pinned to the first node, -1 if free
+  int body_b; // Body index pinned to the last node, -1 if free
+  int iterations;
+  ak_fixed_t rest_length;     // Per segment
+  ak_fixed_t rest_length_sqr; // Per segment
+  ak_fixed_t node_mass;
+  ak_fixed_t inv_node_mass;
+} ak_rope_t;
+
+// Static level geometry as a grid of solid tiles. The tile bytes are owned
+// by the caller (and may live in ROM); nonzero means solid.
+typedef struct {
+  const uint8_t *tiles; // width * height bytes, row-major. NULL if unused
+  int width, height;    // In tiles
+  ak_fixed_t tile_size;
+  ak_fixed_t inv_tile_size;
+  ak_vec2_t origin; // Top-left corner of tile (origin_tx, origin_ty)
+  int32_t origin_tx, origin_ty; // 0 unless the world origin moved far away
+  ak_fixed_t restitution;
+} ak_tilemap_t;
+
+// Static geometry shared by several worlds (see ak_static_world_build)
+#ifndef AK_MAX_STATIC_BODIES
+#define AK_MAX_STATIC_BODIES 64
+#endif
+
+// Grid cells, and body entries across all cells, of a static world's index
+#ifndef AK_MAX_STATIC_CELLS
+#define AK_MAX_STATIC_CELLS 256
+#endif
+
+#ifndef AK_MAX_STATIC_REFS
+#define AK_MAX_STATIC_REFS 256
+#endif
+
+typedef struct {
+  ak_body_t bodies[AK_MAX_STATIC_BODIES];
+  int body_count;
+  // Uniform grid over the bodies' bounds; cols is 0 until built
+  ak_vec2_t min, max;
+  ak_fixed_t cell_size;
+  ak_fixed_t inv_cell_size;
+  int cols, rows;
+  uint16_t cell_start[AK_MAX_STATIC_CELLS + 1]; // Into cell_bodies, per cell
+  uint16_t cell_bodies[AK_MAX_STATIC_REFS];      // Body indices, ascending
+  uint16_t first_col[AK_MAX_STATIC_BODIES];      // Top-left cell of each body
+  uint16_t first_row[AK_MAX_STATIC_BODIES];
+} ak_static_world_t;
+
+// Simulation level of detail (see ak_world_set_lod). Tier t bodies are
+// stepped once every 2^t steps.
+#ifndef AK_LOD_TIERS
+#define AK_LOD_TIERS 3
+#endif
+
+#ifndef AK_MAX_LOD_FOCI
+#define AK_MAX_LOD_FOCI 4
+#endif
+
+typedef struct {
+  ak_vec2_t foci[AK_MAX_LOD_FOCI]; // Local positions (camera, players)
+  int focus_count;                 // 0 puts every body in tier 0
+  // Bodies farther than radius[t] from every focus are in tier t + 1 or
+  // above. Ascending; distances are per axis (squares, not circles).
+  ak_fixed_t radius[AK_LOD_TIERS - 1];
+  uint32_t step;
+  // Per body, by index; valid for the first body_count bodies
+  int body_count;
+  uint8_t tier[AK_MAX_BODIES];
+  uint8_t owed[AK_MAX_BODIES];   // Steps skipped since last integrated
+  uint8_t active[AK_MAX_BODIES]; // Integrated and collided this step
+  int tier_counts[AK_LOD_TIERS]; // Dynamic bodies per tier, last step
+} ak_lod_t;
+
+// Progress of a time-sliced step (see ak_world_step_begin)
+typedef enum {
+  AK_STEP_IDLE,
+  AK_STEP_PAIRS,
+  AK_STEP_STATICS,
+  AK_STEP_TILEMAP,
+  AK_STEP_TETHERS,
+  AK_STEP_ROPES,
+  AK_STEP_DONE
+} ak_step_phase_t;
+
+typedef struct {
+  ak_step_phase_t phase;
+  int i, j; // Cursor into the current phase
+  ak_fixed_t dt;
+  int32_t work; // Work units done by the current or last step
+} ak_step_state_t;
+
+// Budget for ak_world_step_continue that always finishes the step
+#define AK_STEP_UNLIMITED INT32_MAX
+
 typedef struct {
   int body_a_id;
   int body_b_id;
   ak_vec2_t normal;
 } ak_contact_t;
 
+// body_b_id values that are not bodies
+#define AK_CONTACT_NONE -1 // Nothing was touched
+#define AK_CONTACT_TILE -2 // A solid tilemap tile
+
+struct ak_command_queue; // See ak_commands.h
+
 typedef struct {
   ak_fixed_t width;
   ak_fixed_t height;
@@ -70,6 +207,18 @@ typedef struct {
   int body_count;
   ak_tether_t tethers[AK_MAX_TETHERS];
   int tether_count;
+  ak_rope_t ropes[AK_MAX_ROPES];
+  int rope_count;
+  ak_rope_node_t rope_nodes[AK_MAX_ROPE_NODES];
+  int rope_node_count;
+  ak_tilemap_t tilemap;
+  const ak_static_world_t *statics; // Shared static geometry, NULL if none
+  struct ak_command_queue *commands; // Drained at each step, NULL if none
+  ak_lod_t *lod; // Reduced-rate stepping of far bodies, NULL if none
+  int sort_interval;  // Steps between automatic body sorts, 0 = never
+  int sort_countdown; // Steps until the next one
+  ak_step_state_t step;
+  int32_t origin_x, origin_y; // Global pixel position of local (0, 0)
 } ak_world_t;
 
 // Vector Math
@@ -80,13 +229,156 @@ ak_fixed_t ak_vec2_dot(ak_vec2_t a, ak_vec2_t b);
 ak_fixed_t ak_vec2_len_sqr(ak_vec2_t v);
 ak_fixed_t ak_vec2_len(ak_vec2_t v);
 
+// The helpers above do not tally their multiplies and square roots; core code
+// calls them through these, which in -DAK_COUNT_OPS builds tally at the
+// calling line so ak_cost_report charges the caller, not the helper
+#ifdef AK_COUNT_OPS
+ak_vec2_t ak_vec2_mul_at(ak_vec2_t v, ak_fixed_t s, const char *file,
+                         int line);
+ak_fixed_t ak_vec2_dot_at(ak_vec2_t a, ak_vec2_t b, const char *file,
+                          int line);
+ak_fixed_t ak_vec2_len_sqr_at(ak_vec2_t v, const char *file, int line);
+ak_fixed_t ak_vec2_len_at(ak_vec2_t v, const char *file, int line);
+#define AK_VEC2_MUL(v, s) ak_vec2_mul_at((v), (s), __FILE__, __LINE__)
+#define AK_VEC2_DOT(a, b) ak_vec2_dot_at((a), (b), __FILE__, __LINE__)
+#define AK_VEC2_LEN_SQR(v) ak_vec2_len_sqr_at((v), __FILE__, __LINE__)
+#define AK_VEC2_LEN(v) ak_vec2_len_at((v), __FILE__, __LINE__)
+#else
+#define AK_VEC2_MUL(v, s) ak_vec2_mul((v), (s))
+#define AK_VEC2_DOT(a, b) ak_vec2_dot((a), (b))
+#define AK_VEC2_LEN_SQR(v) ak_vec2_len_sqr(v)
+#define AK_VEC2_LEN(v) ak_vec2_len(v)
+#endif
+
 // Physics API
 void ak_world_init(ak_world_t *world, ak_fixed_t width, ak_fixed_t height,
                    ak_vec2_t gravity);
 ak_body_t *ak_world_add_body(ak_world_t *world, ak_shape_t shape, ak_fixed_t x,
                              ak_fixed_t y, ak_fixed_t mass);
+/**
+ * 1 if a body of this shape and mass can be simulated: a known shape type
+ * with positive extents, and a mass of 0 (static) or one whose 1/mass fits.
+ * ak_world_add_body trusts its caller; check data from outside with this.
+ */
+int ak_body_valid(ak_shape_t shape, ak_fixed_t mass);
 void ak_world_add_tether(ak_world_t *world, ak_body_t *a, ak_body_t *b,
                          ak_fixed_t max_length);
+/**
+ * Remove a body along with its tethers; rope ends pinned to it become free.
+ * Later bodies move down one slot (keeping their order), so body pointers and
+ * indices past it are invalidated. Not allowed while a time-sliced step is
+ * running.
+ */
+void ak_world_remove_body(ak_world_t *world, ak_body_t *body);
+// First body with the given id (ids are assigned by the caller), or 0
+ak_body_t *ak_world_find_body(ak_world_t *world, int id);
+/**
+ * Reorder the bodies along a Morton (Z-order) curve of their positions in
+ * 16px cells, so bodies near each other in space are near each other in
+ * memory. Tethers, rope pins and LOD state follow their bodies; ids are
+ * unchanged, but body pointers and indices held elsewhere are not. If remap
+ * is not NULL it receives the new index of every old index (body_count
+ * entries). The sort is stable and cheap on an already mostly sorted world.
+ * Changing the order changes the order pairs are resolved in, so sorted and
+ * unsorted runs differ (each is still deterministic). Returns 1 if any body
+ * moved. Not allowed while a time-sliced step is running.
+ */
+int ak_world_sort_bodies(ak_world_t *world, int *remap);
+/**
+ * Sort the bodies automatically at the start of every steps-th step (0 turns
+ * it off). Keep bodies by id (ak_world_find_body) rather than pointer across
+ * steps when this is on.
+ */
+void ak_world_set_sort_interval(ak_world_t *world, int steps);
+/**
+ * Add a rope of `segments` equal links laid out straight from start to end.
+ * Returns 0 if the world is out of rope or node capacity, or node_mass is not
+ * positive or too small to invert (raw 1 or 2).
+ * Rope segments should stay short (well under 100px) so squared lengths fit
+ * in 16.16.
+ */
+ak_rope_t *ak_world_add_rope(ak_world_t *world, ak_vec2_t start,
+                             ak_vec2_t end, int segments,
+                             ak_fixed_t node_mass);
+/**
+ * Pin one end of a rope (0 = first node, 1 = last node) to a body. The node
+ * is moved onto the body's position. Pass NULL to free the end again.
+ */
+void ak_rope_attach(ak_world_t *world, ak_rope_t *rope, int end,
+                    ak_body_t *body);
+/**
+ * Attach a tilemap as static level geometry (replacing any previous one).
+ * Dynamic bodies only test the tiles they overlap, and tile faces shared with
+ * a solid neighbour are ignored so bodies slide across seams. Pass NULL tiles
+ * to remove it.
+ */
+void ak_world_set_tilemap(ak_world_t *world, const uint8_t *tiles, int width,
+                          int height, ak_fixed_t tile_size, ak_vec2_t origin);
+/**
+ * Static geometry shared read-only by any number of worlds (bot matches,
+ * replays, lookahead copies of one level). Add the static bodies once, build
+ * the grid index, then attach it to each world: dynamic bodies are tested
+ * only against the static bodies in the grid cells they overlap, after the
+ * world's own body pairs. Nothing in it is written during a step, so worlds
+ * stepped on different threads can share one. Rebuild after adding bodies.
+ * It is not moved by ak_world_shift_origin, so do not shift worlds using it.
+ */
+void ak_static_world_init(ak_static_world_t *statics);
+ak_body_t *ak_static_world_add_body(ak_static_world_t *statics,
+                                    ak_shape_t shape, ak_fixed_t x,
+                                    ak_fixed_t y);
+/**
+ * Sort the bodies into a grid of cell_size cells. Returns 0 if the bounds do
+ * not fit 16.16 or the grid needs more than AK_MAX_STATIC_CELLS cells or
+ * AK_MAX_STATIC_REFS entries (try a larger cell size).
+ */
+int ak_static_world_build(ak_static_world_t *statics, ak_fixed_t cell_size);
+// Pass NULL to detach. Not allowed while a time-sliced step is running.
+void ak_world_set_static(ak_world_t *world, const ak_static_world_t *statics);
+/**
+ * Attach a command queue that other threads can push body changes into; it
+ * is drained at the start of every step (see ak_commands.h). Pass NULL to
+ * detach.
+ */
+void ak_world_set_commands(ak_world_t *world,
+                           struct ak_command_queue *commands);
+/**
+ * Level of detail for big worlds that are mostly off-screen. Each step,
+ * dynamic bodies are put in a tier by their distance from the nearest focus
+ * (less their extent and the distance they could move in the longest tier
+ * step, so fast bodies are promoted early). Tier 0 is stepped every step;
+ * tier t only once every 2^t steps, on steps no other far tier uses so the
+ * cost is spread evenly. A far body's step integrates it over all the steps
+ * it skipped, so it is never behind by more than 2^t - 1 steps and catches
+ * up completely when promoted. Keep radius[0] a little beyond the view so
+ * that catch-up happens off-screen. Pairs, tethers, static geometry and the
+ * tilemap are only resolved for bodies being stepped; ropes always are.
+ * ak_world_init detaches the LOD, like the other attachments.
+ */
+// Clears the foci; radius[t] = near_radius * 2^t
+void ak_lod_init(ak_lod_t *lod, ak_fixed_t near_radius);
+// Pass NULL to detach. Not allowed while a time-sliced step is running.
+void ak_world_set_lod(ak_world_t *world, ak_lod_t *lod);
+/**
+ * Large worlds. Bodies, rope nodes and the tilemap live in 16.16 coordinates
+ * relative to a movable whole-pixel origin, so the solver keeps its 32-bit
+ * math however far the game scrolls. Shifting moves the origin by (dx, dy)
+ * pixels (at most 32767 per call) and subtracts that from every local
+ * position; results are unchanged as long as all bodies stay within about
+ * +/-16k px of the origin. Not allowed while a time-sliced step is running.
+ * Particle pools and cameras must be shifted by the same amount.
+ */
+void ak_world_shift_origin(ak_world_t *world, int32_t dx, int32_t dy);
+/**
+ * Shift the origin onto focus (e.g. the player) once it is more than
+ * AK_RECENTER_DISTANCE px away. Returns 1 and the shift in *dx, *dy if it
+ * moved, 0 otherwise.
+ */
+int ak_world_recenter(ak_world_t *world, ak_vec2_t focus, int32_t *dx,
+                      int32_t *dy);
+ak_gvec2_t ak_world_to_global(const ak_world_t *world, ak_vec2_t local);
+// Only meaningful within +/-32k px of the origin
+ak_vec2_t ak_world_to_local(const ak_world_t *world, ak_gvec2_t global);
 /**
  * Step the physics world by dt.
  * NOTE: For consistent cross-platform behavior (physics parity), always use a
@@ -94,6 +386,128 @@ void ak_world_add_tether(ak_world_t *world, ak_body_t *a, ak_body_t *b,
  * rate, call this multiple times with the fixed dt.
  */
 void ak_world_step(ak_world_t *world, ak_fixed_t dt);
+/**
+ * Time-sliced stepping, for frames that cannot afford a whole step at once.
+ * ak_world_step_begin integrates the bodies; each ak_world_step_continue
+ * then resolves at most max_work_units more work and returns 1 once the step
+ * is complete; ak_world_step_end finishes any remaining work. A work unit is
+ * one body pair, one body against the static world or the tilemap, one
+ * tether, or one rope link per iteration (a rope is never split, so the last
+ * call may run over).
+ * begin/continue.../end gives the same result as ak_world_step(world, dt).
+ * world->step.work counts the units done (for ak_world_step too, but not
+ * for the specialized variants below).
+ * Do not add bodies, tethers or ropes while a step is in progress.
+ */
+void ak_world_step_begin(ak_world_t *world, ak_fixed_t dt);
+int ak_world_step_continue(ak_world_t *world, int32_t max_work_units);
+void ak_world_step_end(ak_world_t *world);
+/**
+ * Predict body's path over the next steps steps of dt without stepping the
+ * world, e.g. for aim lines. The body is integrated alone, with the same
+ * integrator and narrowphase as ak_world_step, against the other bodies, the
+ * shared statics and the tilemap frozen where they are now; tethers and
+ * ropes are ignored. body is the world's own body (it is not tested against
+ * itself) or one not in the world yet, such as a projectile about to be
+ * fired. Writes each step's position to out_points and stops after the
+ * first step that touches anything (that last point is before any collision
+ * response), reporting it in contact (if not NULL;
+ * body_b_id is the id hit, AK_CONTACT_TILE or AK_CONTACT_NONE). Returns the
+ * number of points written.
+ */
+int ak_predict_trajectory(const ak_world_t *world, const ak_body_t *body,
+                          ak_fixed_t dt, int steps, ak_vec2_t *out_points,
+                          ak_contact_t *contact);
+
+// Shape subsets for the specialized step variants
+#define AK_STEP_SHAPES_ANY 0
+#define AK_STEP_SHAPES_CIRCLE 1 // Every body is a circle
+#define AK_STEP_SHAPES_AABB 2   // Every body is an AABB
+
+/*
+ * Specialized step variants, as an X-macro list of
+ *   X(name, shapes, has_static, has_tethers)
+ * Each entry generates ak_world_step_<name>(world, dt), a whole step with the
+ * shape dispatch, static-body checks and tether phase compiled out as the
+ * flags allow. The caller guarantees the world fits the variant (e.g. only
+ * circles, or no static bodies); results are then identical to
+ * ak_world_step, which remains the fallback for everything else. Define
+ * AK_STEP_VARIANTS before including this header to build a different set.
+ */
+#ifndef AK_STEP_VARIANTS
+#define AK_STEP_VARIANTS(X)                                                    \
+  X(circles, AK_STEP_SHAPES_CIRCLE, 1, 1)                                      \
+  X(circles_no_tethers, AK_STEP_SHAPES_CIRCLE, 1, 0)                           \
+  X(aabbs, AK_STEP_SHAPES_AABB, 1, 1)                                          \
+  X(no_tethers, AK_STEP_SHAPES_ANY, 1, 0)                                      \
+  X(no_static, AK_STEP_SHAPES_ANY, 0, 1)
+#endif
+
+#define AK_DECLARE_STEP_VARIANT(name, shapes, has_static, has_tethers)         \
+  void ak_world_step_##name(ak_world_t *world, ak_fixed_t dt);
+AK_STEP_VARIANTS(AK_DECLARE_STEP_VARIANT)
+
+/*
+ * World packs: several structurally identical worlds (same bodies, shapes,
+ * static flags and tethers; positions, velocities, masses, sizes and world
+ * settings free to differ) stepped together, e.g. AI lookahead over many
+ * inputs. Each body field is stored once per lane (one world per lane), so
+ * integration and the pair and tether rejection tests run as fixed-length
+ * lane loops the compiler turns into vector code. Lanes that may touch fall
+ * back to the scalar solver for that pair or tether, so every lane's result
+ * is bit-identical to stepping its world with ak_world_step.
+ */
+#ifndef AK_PACK_LANES
+#define AK_PACK_LANES 4
+#endif
+
+// One body of every packed world; each field holds one value per lane
+typedef struct {
+  ak_fixed_t px[AK_PACK_LANES], py[AK_PACK_LANES];
+  ak_fixed_t vx[AK_PACK_LANES], vy[AK_PACK_LANES];
+  ak_fixed_t fx[AK_PACK_LANES], fy[AK_PACK_LANES];
+  ak_fixed_t inv_mass[AK_PACK_LANES];
+  ak_fixed_t gravity_mass[AK_PACK_LANES]; // 1 / inv_mass, as the step uses
+  ak_fixed_t restitution[AK_PACK_LANES];
+  ak_fixed_t ex[AK_PACK_LANES], ey[AK_PACK_LANES]; // Radius, or half size
+} ak_pack_body_t;
+
+typedef struct {
+  int a, b; // Body indices, the same in every lane
+  ak_fixed_t max_length[AK_PACK_LANES];
+  ak_fixed_t max_length_sqr[AK_PACK_LANES];
+} ak_pack_tether_t;
+
+typedef struct {
+  int world_count; // Lanes holding a world; the others repeat lane 0
+  int body_count;
+  int tether_count;
+  ak_fixed_t gx[AK_PACK_LANES], gy[AK_PACK_LANES];
+  ak_fixed_t slop[AK_PACK_LANES];
+  ak_fixed_t max_correction[AK_PACK_LANES];
+  uint8_t shape[AK_MAX_BODIES]; // ak_shape_type_t
+  uint8_t is_static[AK_MAX_BODIES];
+  ak_pack_body_t bodies[AK_MAX_BODIES];
+  ak_pack_tether_t tethers[AK_MAX_TETHERS];
+} ak_world_pack_t;
+
+/**
+ * Load count (1 to AK_PACK_LANES) worlds into the pack's lanes. Returns 0
+ * if the worlds differ in structure or use anything the pack does not step:
+ * ropes, a tilemap, shared statics, a LOD, a command queue, automatic
+ * sorting, or a time-sliced step in progress.
+ */
+int ak_world_pack_load(ak_world_pack_t *pack, const ak_world_t *const *worlds,
+                       int count);
+// Step every lane by dt, as ak_world_step would step its world
+void ak_world_pack_step(ak_world_pack_t *pack, ak_fixed_t dt);
+/**
+ * Copy lane's body positions, velocities and forces into world, which must
+ * have the pack's body count (the world loaded into the lane, or a copy).
+ * Returns 0 if it does not.
+ */
+int ak_world_pack_store(const ak_world_pack_t *pack, int lane,
+                        ak_world_t *world);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,289 @@
+#include "ak_scene.h"
+
+// --- Little-endian words ---
+
+static uint32_t GetU32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static void PutU32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+#define GET_FIXED(p) ((ak_fixed_t)GetU32(p))
+#define PUT_FIXED(p, v) PutU32((p), (uint32_t)(v))
+
+// --- Records ---
+
+void ak_scene_encode_header(uint8_t *out, const ak_scene_header_t *h) {
+  PutU32(out + 0, h->magic);
+  PutU32(out + 4, h->version);
+  PUT_FIXED(out + 8, h->width);
+  PUT_FIXED(out + 12, h->height);
+  PUT_FIXED(out + 16, h->gravity.x);
+  PUT_FIXED(out + 20, h->gravity.y);
+  PutU32(out + 24, h->body_count);
+  PutU32(out + 28, h->tether_count);
+  PutU32(out + 32, h->rope_count);
+}
+
+void ak_scene_decode_header(const uint8_t *in, ak_scene_header_t *h) {
+  h->magic = GetU32(in + 0);
+  h->version = GetU32(in + 4);
+  h->width = GET_FIXED(in + 8);
+  h->height = GET_FIXED(in + 12);
+  h->gravity.x = GET_FIXED(in + 16);
+  h->gravity.y = GET_FIXED(in + 20);
+  h->body_count = GetU32(in + 24);
+  h->tether_count = GetU32(in + 28);
+  h->rope_count = GetU32(in + 32);
+}
+
+void ak_scene_encode_body(uint8_t *out, const ak_scene_body_t *b) {
+  PUT_FIXED(out + 0, b->position.x);
+  PUT_FIXED(out + 4, b->position.y);
+  PUT_FIXED(out + 8, b->velocity.x);
+  PUT_FIXED(out + 12, b->velocity.y);
+  PUT_FIXED(out + 16, b->mass);
+  PUT_FIXED(out + 20, b->restitution);
+  PutU32(out + 24, b->shape_type);
+  PUT_FIXED(out + 28, b->extent_x);
+  PUT_FIXED(out + 32, b->extent_y);
+}
+
+void ak_scene_decode_body(const uint8_t *in, ak_scene_body_t *b) {
+  b->position.x = GET_FIXED(in + 0);
+  b->position.y = GET_FIXED(in + 4);
+  b->velocity.x = GET_FIXED(in + 8);
+  b->velocity.y = GET_FIXED(in + 12);
+  b->mass = GET_FIXED(in + 16);
+  b->restitution = GET_FIXED(in + 20);
+  b->shape_type = GetU32(in + 24);
+  b->extent_x = GET_FIXED(in + 28);
+  b->extent_y = GET_FIXED(in + 32);
+}
+
+void ak_scene_encode_tether(uint8_t *out, const ak_scene_tether_t *t) {
+  PutU32(out + 0, t->a);
+  PutU32(out + 4, t->b);
+  PUT_FIXED(out + 8, t->max_length);
+}
+
+void ak_scene_decode_tether(const uint8_t *in, ak_scene_tether_t *t) {
+  t->a = GetU32(in + 0);
+  t->b = GetU32(in + 4);
+  t->max_length = GET_FIXED(in + 8);
+}
+
+void ak_scene_encode_rope(uint8_t *out, const ak_scene_rope_t *r) {
+  PUT_FIXED(out + 0, r->start.x);
+  PUT_FIXED(out + 4, r->start.y);
+  PUT_FIXED(out + 8, r->end.x);
+  PUT_FIXED(out + 12, r->end.y);
+  PutU32(out + 16, r->segments);
+  PUT_FIXED(out + 20, r->rest_length);
+  PUT_FIXED(out + 24, r->node_mass);
+  PutU32(out + 28, (uint32_t)r->body_a);
+  PutU32(out + 32, (uint32_t)r->body_b);
+  PutU32(out + 36, r->iterations);
+}
+
+void ak_scene_decode_rope(const uint8_t *in, ak_scene_rope_t *r) {
+  r->start.x = GET_FIXED(in + 0);
+  r->start.y = GET_FIXED(in + 4);
+  r->end.x = GET_FIXED(in + 8);
+  r->end.y = GET_FIXED(in + 12);
+  r->segments = GetU32(in + 16);
+  r->rest_length = GET_FIXED(in + 20);
+  r->node_mass = GET_FIXED(in + 24);
+  r->body_a = (int32_t)GetU32(in + 28);
+  r->body_b = (int32_t)GetU32(in + 32);
+  r->iterations = GetU32(in + 36);
+}
+
+int ak_scene_body_shape(const ak_scene_body_t *r, ak_shape_t *shape) {
+  if (r->shape_type == AK_SHAPE_AABB) {
+    shape->type = AK_SHAPE_AABB;
+    shape->bounds.aabb.width = r->extent_x;
+    shape->bounds.aabb.height = r->extent_y;
+  } else if (r->shape_type == AK_SHAPE_CIRCLE) {
+    shape->type = AK_SHAPE_CIRCLE;
+    shape->bounds.circle.radius = r->extent_x;
+  } else {
+    return 0;
+  }
+  return ak_body_valid(*shape, r->mass);
+}
+
+// --- World ---
+
+ak_scene_result_t ak_scene_load(ak_world_t *world, const void *data,
+                                size_t size) {
+  const uint8_t *p = (const uint8_t *)data;
+  ak_scene_header_t h;
+  uint32_t i;
+
+  if (size < AK_SCENE_HEADER_SIZE)
+    return AK_SCENE_ERR_TRUNCATED;
+  ak_scene_decode_header(p, &h);
+  if (h.magic != AK_SCENE_MAGIC)
+    return AK_SCENE_ERR_FORMAT;
+  if (h.version > AK_SCENE_VERSION)
+    return AK_SCENE_ERR_VERSION;
+  if (h.body_count > AK_MAX_BODIES || h.tether_count > AK_MAX_TETHERS ||
+      h.rope_count > AK_MAX_ROPES)
+    return AK_SCENE_ERR_CAPACITY;
+
+  // Counts are bounded by the capacities above, so this cannot overflow
+  size_t bodies_at = AK_SCENE_HEADER_SIZE;
+  size_t tethers_at = bodies_at + (size_t)h.body_count * AK_SCENE_BODY_SIZE;
+  size_t ropes_at = tethers_at + (size_t)h.tether_count * AK_SCENE_TETHER_SIZE;
+  size_t end = ropes_at + (size_t)h.rope_count * AK_SCENE_ROPE_SIZE;
+  if (size < end)
+    return AK_SCENE_ERR_TRUNCATED;
+
+  // Validate bodies and references before touching the world
+  for (i = 0; i < h.body_count; i++) {
+    ak_scene_body_t r;
+    ak_shape_t shape;
+    ak_scene_decode_body(p + bodies_at + i * AK_SCENE_BODY_SIZE, &r);
+    if (!ak_scene_body_shape(&r, &shape))
+      return AK_SCENE_ERR_FORMAT;
+  }
+  uint32_t rope_nodes = 0;
+  for (i = 0; i < h.tether_count; i++) {
+    ak_scene_tether_t t;
+    ak_scene_decode_tether(p + tethers_at + i * AK_SCENE_TETHER_SIZE, &t);
+    if (t.a >= h.body_count || t.b >= h.body_count)
+      return AK_SCENE_ERR_FORMAT;
+  }
+  for (i = 0; i < h.rope_count; i++) {
+    ak_scene_rope_t r;
+    ak_scene_decode_rope(p + ropes_at + i * AK_SCENE_ROPE_SIZE, &r);
+    // Node masses follow the body rule: positive with an invertible 1/mass
+    if (r.segments < 1 || r.node_mass <= 0 ||
+        AK_FIXED_DIV(AK_FIXED_ONE, r.node_mass) <= 0 ||
+        r.body_a >= (int32_t)h.body_count ||
+        r.body_b >= (int32_t)h.body_count)
+      return AK_SCENE_ERR_FORMAT;
+    if (r.segments >= AK_MAX_ROPE_NODES)
+      return AK_SCENE_ERR_CAPACITY;
+    rope_nodes += r.segments + 1;
+    if (rope_nodes > AK_MAX_ROPE_NODES)
+      return AK_SCENE_ERR_CAPACITY;
+  }
+
+  ak_world_init(world, h.width, h.height, h.gravity);
+
+  for (i = 0; i < h.body_count; i++) {
+    ak_scene_body_t r;
+    ak_shape_t shape;
+    ak_scene_decode_body(p + bodies_at + i * AK_SCENE_BODY_SIZE, &r);
+    ak_scene_body_shape(&r, &shape); // Checked above
+    ak_body_t *b = ak_world_add_body(world, shape, r.position.x, r.position.y,
+                                     r.mass);
+    b->velocity = r.velocity;
+    b->restitution = r.restitution;
+  }
+
+  for (i = 0; i < h.tether_count; i++) {
+    ak_scene_tether_t t;
+    ak_scene_decode_tether(p + tethers_at + i * AK_SCENE_TETHER_SIZE, &t);
+    ak_world_add_tether(world, &world->bodies[t.a], &world->bodies[t.b],
+                        t.max_length);
+  }
+
+  for (i = 0; i < h.rope_count; i++) {
+    ak_scene_rope_t r;
+    ak_scene_decode_rope(p + ropes_at + i * AK_SCENE_ROPE_SIZE, &r);
+    ak_rope_t *rope = ak_world_add_rope(world, r.start, r.end,
+                                        (int)r.segments, r.node_mass);
+    if (r.rest_length > 0) {
+      rope->rest_length = r.rest_length;
+      rope->rest_length_sqr = AK_FIXED_MUL(r.rest_length, r.rest_length);
+    }
+    if (r.iterations > 0)
+      rope->iterations = (int)r.iterations;
+    if (r.body_a >= 0)
+      ak_rope_attach(world, rope, 0, &world->bodies[r.body_a]);
+    if (r.body_b >= 0)
+      ak_rope_attach(world, rope, 1, &world->bodies[r.body_b]);
+  }
+
+  return AK_SCENE_OK;
+}
+
+size_t ak_scene_save(const ak_world_t *world, void *out, size_t capacity) {
+  size_t needed = AK_SCENE_HEADER_SIZE +
+                  (size_t)world->body_count * AK_SCENE_BODY_SIZE +
+                  (size_t)world->tether_count * AK_SCENE_TETHER_SIZE +
+                  (size_t)world->rope_count * AK_SCENE_ROPE_SIZE;
+  if (needed > capacity)
+    return needed;
+
+  uint8_t *p = (uint8_t *)out;
+  ak_scene_header_t h;
+  int i;
+
+  h.magic = AK_SCENE_MAGIC;
+  h.version = AK_SCENE_VERSION;
+  h.width = world->width;
+  h.height = world->height;
+  h.gravity = world->gravity;
+  h.body_count = (uint32_t)world->body_count;
+  h.tether_count = (uint32_t)world->tether_count;
+  h.rope_count = (uint32_t)world->rope_count;
+  ak_scene_encode_header(p, &h);
+  p += AK_SCENE_HEADER_SIZE;
+
+  for (i = 0; i < world->body_count; i++) {
+    const ak_body_t *b = &world->bodies[i];
+    ak_scene_body_t r;
+    r.position = b->position;
+    r.velocity = b->velocity;
+    r.mass = b->is_static ? 0 : b->mass;
+    r.restitution = b->restitution;
+    r.shape_type = (uint32_t)b->shape.type;
+    if (b->shape.type == AK_SHAPE_AABB) {
+      r.extent_x = b->shape.bounds.aabb.width;
+      r.extent_y = b->shape.bounds.aabb.height;
+    } else {
+      r.extent_x = b->shape.bounds.circle.radius;
+      r.extent_y = 0;
+    }
+    ak_scene_encode_body(p, &r);
+    p += AK_SCENE_BODY_SIZE;
+  }
+
+  for (i = 0; i < world->tether_count; i++) {
+    const ak_tether_t *t = &world->tethers[i];
+    ak_scene_tether_t r;
+    r.a = (uint32_t)t->a;
+    r.b = (uint32_t)t->b;
+    r.max_length = t->max_length;
+    ak_scene_encode_tether(p, &r);
+    p += AK_SCENE_TETHER_SIZE;
+  }
+
+  for (i = 0; i < world->rope_count; i++) {
+    const ak_rope_t *rope = &world->ropes[i];
+    const ak_rope_node_t *n = &world->rope_nodes[rope->first_node];
+    ak_scene_rope_t r;
+    r.start = n[0].position;
+    r.end = n[rope->node_count - 1].position;
+    r.segments = (uint32_t)(rope->node_count - 1);
+    r.rest_length = rope->rest_length;
+    r.node_mass = rope->node_mass;
+    r.body_a = rope->body_a;
+    r.body_b = rope->body_b;
+    r.iterations = (uint32_t)rope->iterations;
+    ak_scene_encode_rope(p, &r);
+    p += AK_SCENE_ROPE_SIZE;
+  }
+
+  return needed;
+}
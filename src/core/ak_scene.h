@@ -0,0 +1,110 @@
+#ifndef AK_SCENE_H
+#define AK_SCENE_H
+
+#include "ak_physics.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Binary scene format (.aks)
+ *
+ * All fields are 32-bit little-endian words, so every record is 4-byte
+ * aligned and a memory-mapped file can be read in place:
+ *
+ *   header                                   AK_SCENE_HEADER_SIZE
+ *   body records   x header.body_count       AK_SCENE_BODY_SIZE each
+ *   tether records x header.tether_count     AK_SCENE_TETHER_SIZE each
+ *   rope records   x header.rope_count       AK_SCENE_ROPE_SIZE each
+ *
+ * Fixed-point fields are raw 16.16 values. Body indices refer to the order
+ * of the body records.
+ */
+
+#define AK_SCENE_MAGIC 0x43534B41u // "AKSC"
+#define AK_SCENE_VERSION 1
+
+#define AK_SCENE_HEADER_SIZE 36
+#define AK_SCENE_BODY_SIZE 36
+#define AK_SCENE_TETHER_SIZE 12
+#define AK_SCENE_ROPE_SIZE 40
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  ak_fixed_t width, height;
+  ak_vec2_t gravity;
+  uint32_t body_count;
+  uint32_t tether_count;
+  uint32_t rope_count;
+} ak_scene_header_t;
+
+typedef struct {
+  ak_vec2_t position;
+  ak_vec2_t velocity;
+  ak_fixed_t mass; // 0 for static
+  ak_fixed_t restitution;
+  uint32_t shape_type;   // ak_shape_type_t
+  ak_fixed_t extent_x;   // Radius, or AABB half-width
+  ak_fixed_t extent_y;   // AABB half-height, 0 for circles
+} ak_scene_body_t;
+
+typedef struct {
+  uint32_t a, b;
+  ak_fixed_t max_length;
+} ak_scene_tether_t;
+
+typedef struct {
+  ak_vec2_t start, end;
+  uint32_t segments;
+  ak_fixed_t rest_length; // Per segment; 0 to span start..end exactly
+  ak_fixed_t node_mass;
+  int32_t body_a, body_b; // -1 for a free end
+  uint32_t iterations;
+} ak_scene_rope_t;
+
+typedef enum {
+  AK_SCENE_OK = 0,
+  AK_SCENE_ERR_FORMAT,    // Bad magic, out-of-range index or invalid body
+  AK_SCENE_ERR_VERSION,   // Written by a newer format version
+  AK_SCENE_ERR_TRUNCATED, // Fewer bytes than the header promises
+  AK_SCENE_ERR_CAPACITY   // Exceeds AK_MAX_* of this build
+} ak_scene_result_t;
+
+/**
+ * Replace the contents of world with the scene in data. The buffer is read
+ * in place (e.g. straight from mmap) and not referenced afterwards. On error
+ * the world is left untouched.
+ */
+ak_scene_result_t ak_scene_load(ak_world_t *world, const void *data,
+                                size_t size);
+
+/**
+ * Serialize world into out. Returns the number of bytes the scene needs; if
+ * that exceeds capacity nothing is written, so pass capacity 0 to query.
+ */
+size_t ak_scene_save(const ak_world_t *world, void *out, size_t capacity);
+
+// Record encoders/decoders, for tools that stream scenes without a world
+void ak_scene_encode_header(uint8_t *out, const ak_scene_header_t *h);
+void ak_scene_encode_body(uint8_t *out, const ak_scene_body_t *b);
+void ak_scene_encode_tether(uint8_t *out, const ak_scene_tether_t *t);
+void ak_scene_encode_rope(uint8_t *out, const ak_scene_rope_t *r);
+void ak_scene_decode_header(const uint8_t *in, ak_scene_header_t *h);
+void ak_scene_decode_body(const uint8_t *in, ak_scene_body_t *b);
+void ak_scene_decode_tether(const uint8_t *in, ak_scene_tether_t *t);
+void ak_scene_decode_rope(const uint8_t *in, ak_scene_rope_t *r);
+/**
+ * The shape of body record r. Returns 0 if the record cannot be simulated:
+ * a negative mass, a mass too small to invert, an unknown shape type or a
+ * non-positive extent.
+ */
+int ak_scene_body_shape(const ak_scene_body_t *r, ak_shape_t *shape);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_SCENE_H
@@ -0,0 +1,333 @@
+#include "ak_sectors.h"
+
+// --- Little-endian words ---
+
+static uint32_t GetU32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static void PutU32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+// --- Records ---
+
+void ak_sector_encode_header(uint8_t *out, const ak_sector_header_t *h) {
+  PutU32(out + 0, h->magic);
+  PutU32(out + 4, h->version);
+  PutU32(out + 8, (uint32_t)h->sector_size);
+  PutU32(out + 12, (uint32_t)h->cols);
+  PutU32(out + 16, (uint32_t)h->rows);
+  PutU32(out + 20, (uint32_t)h->origin_x);
+  PutU32(out + 24, (uint32_t)h->origin_y);
+}
+
+void ak_sector_decode_header(const uint8_t *in, ak_sector_header_t *h) {
+  h->magic = GetU32(in + 0);
+  h->version = GetU32(in + 4);
+  h->sector_size = (int32_t)GetU32(in + 8);
+  h->cols = (int32_t)GetU32(in + 12);
+  h->rows = (int32_t)GetU32(in + 16);
+  h->origin_x = (int32_t)GetU32(in + 20);
+  h->origin_y = (int32_t)GetU32(in + 24);
+}
+
+void ak_sector_encode_entry(uint8_t *out, const ak_sector_entry_t *e) {
+  PutU32(out + 0, e->offset);
+  PutU32(out + 4, e->body_count);
+}
+
+void ak_sector_decode_entry(const uint8_t *in, ak_sector_entry_t *e) {
+  e->offset = GetU32(in + 0);
+  e->body_count = GetU32(in + 4);
+}
+
+// --- Streaming ---
+
+int ak_sectors_init(ak_sectors_t *sectors, const void *header,
+                    ak_sector_io_t io, int id_base) {
+  ak_sector_header_t h;
+  ak_sector_decode_header((const uint8_t *)header, &h);
+  if (h.magic != AK_SECTOR_MAGIC || h.version != AK_SECTOR_VERSION ||
+      h.sector_size <= 0 || h.cols <= 0 || h.rows <= 0 ||
+      h.cols > AK_MAX_SECTORS / h.rows || id_base <= 0)
+    return 0;
+
+  sectors->sector_size = h.sector_size;
+  sectors->cols = (int)h.cols;
+  sectors->rows = (int)h.rows;
+  sectors->origin_x = h.origin_x;
+  sectors->origin_y = h.origin_y;
+  sectors->id_base = id_base;
+  sectors->load_margin = h.sector_size / 2;
+  sectors->unload_margin = h.sector_size;
+  sectors->io = io;
+  for (int s = 0; s < AK_MAX_SECTORS; s++)
+    sectors->state[s] = AK_SECTOR_OUT;
+  for (int k = 0; k < AK_SECTOR_READS; k++)
+    sectors->reading[k] = -1;
+  ak_sector_stats_t zero = {0};
+  sectors->stats = zero;
+  return 1;
+}
+
+int ak_sectors_pending(const ak_sectors_t *sectors) {
+  int n = 0;
+  for (int k = 0; k < AK_SECTOR_READS; k++)
+    n += sectors->reading[k] >= 0;
+  return n;
+}
+
+// Floor division, for focus positions left of or above the level
+static int32_t FloorDiv(int32_t a, int32_t b) {
+  int32_t q = a / b;
+  return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+// Whether sector s lies within margin px of a focus, per axis like the LOD
+static int NearFocus(const ak_sectors_t *sec, const ak_world_t *world,
+                     const ak_vec2_t *foci, int focus_count, int s,
+                     int32_t margin) {
+  int32_t x0 = sec->origin_x + (int32_t)(s % sec->cols) * sec->sector_size;
+  int32_t y0 = sec->origin_y + (int32_t)(s / sec->cols) * sec->sector_size;
+  int32_t x1 = x0 + sec->sector_size;
+  int32_t y1 = y0 + sec->sector_size;
+  for (int f = 0; f < focus_count; f++) {
+    int32_t fx = (int32_t)AK_FIXED_TO_INT(foci[f].x) + world->origin_x;
+    int32_t fy = (int32_t)AK_FIXED_TO_INT(foci[f].y) + world->origin_y;
+    if (fx >= x0 - margin && fx <= x1 + margin && fy >= y0 - margin &&
+        fy <= y1 + margin)
+      return 1;
+  }
+  return 0;
+}
+
+// The sector's top-left corner in local 16.16
+static ak_vec2_t SectorCorner(const ak_sectors_t *sec, const ak_world_t *world,
+                              int s) {
+  int32_t x = sec->origin_x + (int32_t)(s % sec->cols) * sec->sector_size;
+  int32_t y = sec->origin_y + (int32_t)(s / sec->cols) * sec->sector_size;
+  return (ak_vec2_t){AK_INT_TO_FIXED(x - world->origin_x),
+                     AK_INT_TO_FIXED(y - world->origin_y)};
+}
+
+// The sector containing local position p, -1 if outside the level
+static int SectorAt(const ak_sectors_t *sec, const ak_world_t *world,
+                    ak_vec2_t p) {
+  int32_t c = FloorDiv((int32_t)AK_FIXED_TO_INT(p.x) + world->origin_x -
+                           sec->origin_x,
+                       sec->sector_size);
+  int32_t r = FloorDiv((int32_t)AK_FIXED_TO_INT(p.y) + world->origin_y -
+                           sec->origin_y,
+                       sec->sector_size);
+  if (c < 0 || r < 0 || c >= sec->cols || r >= sec->rows)
+    return -1;
+  return (int)(r * sec->cols + c);
+}
+
+// An id in sector s's range that no body has, 0 if the sector is full
+static int FreeId(const ak_sectors_t *sec, const ak_world_t *world, int s) {
+  int first = sec->id_base + s * AK_MAX_SECTOR_BODIES;
+  uint8_t used[AK_MAX_SECTOR_BODIES] = {0};
+  for (int i = 0; i < world->body_count; i++) {
+    int id = world->bodies[i].id;
+    if (id >= first && id < first + AK_MAX_SECTOR_BODIES)
+      used[id - first] = 1;
+  }
+  for (int k = 0; k < AK_MAX_SECTOR_BODIES; k++)
+    if (!used[k])
+      return first + k;
+  return 0;
+}
+
+// Local coordinate p (world origin `origin`) relative to the global pixel
+// `corner`, clamped to the +/-32k px a record holds. Returns 0 if clamped.
+static int Relative(ak_fixed_t p, int32_t origin, int32_t corner,
+                    ak_fixed_t *out) {
+  int32_t px = (int32_t)AK_FIXED_TO_INT(p) + origin - corner;
+  if (px < -32767) {
+    *out = -AK_INT_TO_FIXED(32767);
+    return 0;
+  }
+  if (px > 32767) {
+    *out = AK_INT_TO_FIXED(32767);
+    return 0;
+  }
+  *out = AK_INT_TO_FIXED(px) + (p & (AK_FIXED_ONE - 1));
+  return 1;
+}
+
+static void Insert(ak_sectors_t *sec, ak_world_t *world, int s,
+                   const uint8_t *data, int count) {
+  ak_vec2_t corner = SectorCorner(sec, world, s);
+  for (int k = 0; k < count; k++) {
+    ak_scene_body_t r;
+    ak_shape_t shape;
+    ak_scene_decode_body(data + k * AK_SCENE_BODY_SIZE, &r);
+    if (!ak_scene_body_shape(&r, &shape)) {
+      sec->stats.failed++; // Dropped; the sector is saved without it
+      continue;
+    }
+    ak_body_t *b = ak_world_add_body(world, shape, corner.x + r.position.x,
+                                     corner.y + r.position.y, r.mass);
+    b->velocity = r.velocity;
+    b->restitution = r.restitution;
+    b->id = sec->id_base + s * AK_MAX_SECTOR_BODIES + k;
+    sec->stats.bodies_in++;
+  }
+}
+
+// Writes the sector's bodies out and removes them, after handing bodies
+// that have moved into another loaded sector over to it. Returns 0 (and
+// leaves the rest) if a body is in a sector near a focus that cannot take it
+// yet, or the write cannot be queued.
+static int Unload(ak_sectors_t *sec, ak_world_t *world, int s,
+                  const ak_vec2_t *foci, int focus_count) {
+  int first = sec->id_base + s * AK_MAX_SECTOR_BODIES;
+  for (int i = 0; i < world->body_count; i++) {
+    ak_body_t *b = &world->bodies[i];
+    if (b->id < first || b->id >= first + AK_MAX_SECTOR_BODIES)
+      continue;
+    int c = SectorAt(sec, world, b->position);
+    if (c < 0 || c == s)
+      continue;
+    int id = sec->state[c] == AK_SECTOR_IN ? FreeId(sec, world, c) : 0;
+    if (id) {
+      b->id = id;
+      sec->stats.moved++;
+    } else if (NearFocus(sec, world, foci, focus_count, c,
+                         sec->unload_margin)) {
+      return 0; // Would vanish in view; wait for c to load or make room
+    }
+  }
+
+  int32_t x0 = sec->origin_x + (int32_t)(s % sec->cols) * sec->sector_size;
+  int32_t y0 = sec->origin_y + (int32_t)(s / sec->cols) * sec->sector_size;
+  int count = 0, dropped = 0, clamped = 0;
+  for (int i = 0; i < world->body_count; i++) {
+    const ak_body_t *b = &world->bodies[i];
+    if (b->id < first || b->id >= first + AK_MAX_SECTOR_BODIES)
+      continue;
+    if (count == AK_MAX_SECTOR_BODIES) {
+      dropped++; // Only bodies sharing ids in the range can get here
+      continue;
+    }
+    // Bodies outside the level, or in a sector that is out, are saved
+    // with this one
+    ak_scene_body_t r;
+    int fits = Relative(b->position.x, world->origin_x, x0, &r.position.x);
+    fits &= Relative(b->position.y, world->origin_y, y0, &r.position.y);
+    clamped += !fits;
+    r.velocity = b->velocity;
+    r.mass = b->is_static ? 0 : b->mass;
+    r.restitution = b->restitution;
+    r.shape_type = (uint32_t)b->shape.type;
+    if (b->shape.type == AK_SHAPE_AABB) {
+      r.extent_x = b->shape.bounds.aabb.width;
+      r.extent_y = b->shape.bounds.aabb.height;
+    } else {
+      r.extent_x = b->shape.bounds.circle.radius;
+      r.extent_y = 0;
+    }
+    ak_scene_encode_body(sec->scratch + count * AK_SCENE_BODY_SIZE, &r);
+    count++;
+  }
+  if (!sec->io.write(sec->io.ctx, s, sec->scratch,
+                     (uint32_t)count * AK_SCENE_BODY_SIZE))
+    return 0;
+
+  // Remove from the end so the indices still to visit do not move
+  for (int i = world->body_count - 1; i >= 0; i--) {
+    int id = world->bodies[i].id;
+    if (id >= first && id < first + AK_MAX_SECTOR_BODIES)
+      ak_world_remove_body(world, &world->bodies[i]);
+  }
+  sec->stats.bodies_out += (uint32_t)count;
+  sec->stats.dropped += (uint32_t)dropped;
+  sec->stats.clamped += (uint32_t)clamped;
+  sec->stats.unloaded++;
+  return 1;
+}
+
+void ak_sectors_update(ak_sectors_t *sec, ak_world_t *world,
+                       const ak_vec2_t *foci, int focus_count) {
+  if (world->step.phase != AK_STEP_IDLE)
+    return;
+
+  // Finished reads
+  for (int k = 0; k < AK_SECTOR_READS; k++) {
+    int s = sec->reading[k];
+    if (s < 0)
+      continue;
+    int32_t got = sec->io.poll(sec->io.ctx, s);
+    if (got == AK_SECTOR_PENDING)
+      continue;
+    if (got < 0 || got % AK_SCENE_BODY_SIZE != 0) {
+      sec->stats.failed++;
+    } else if (!NearFocus(sec, world, foci, focus_count, s,
+                          sec->unload_margin)) {
+      sec->stats.discarded++; // Still on disk as it was
+    } else {
+      int count = (int)(got / AK_SCENE_BODY_SIZE);
+      if (world->body_count + count > AK_MAX_BODIES) {
+        sec->stats.deferred++;
+        continue; // Keep the data until there is room
+      }
+      Insert(sec, world, s, sec->buffers[k], count);
+      sec->state[s] = AK_SECTOR_IN;
+      sec->stats.loaded++;
+      sec->reading[k] = -1;
+      continue;
+    }
+    sec->state[s] = AK_SECTOR_OUT;
+    sec->reading[k] = -1;
+  }
+
+  // Far sectors
+  int count = sec->cols * sec->rows;
+  for (int s = 0; s < count; s++) {
+    if (sec->state[s] == AK_SECTOR_IN &&
+        !NearFocus(sec, world, foci, focus_count, s, sec->unload_margin) &&
+        Unload(sec, world, s, foci, focus_count))
+      sec->state[s] = AK_SECTOR_OUT;
+  }
+
+  // Reads for sectors coming into range, around each focus
+  for (int f = 0; f < focus_count; f++) {
+    int32_t fx = (int32_t)AK_FIXED_TO_INT(foci[f].x) + world->origin_x;
+    int32_t fy = (int32_t)AK_FIXED_TO_INT(foci[f].y) + world->origin_y;
+    int32_t m = sec->load_margin;
+    int32_t c0 = FloorDiv(fx - m - sec->origin_x, sec->sector_size);
+    int32_t c1 = FloorDiv(fx + m - sec->origin_x, sec->sector_size);
+    int32_t r0 = FloorDiv(fy - m - sec->origin_y, sec->sector_size);
+    int32_t r1 = FloorDiv(fy + m - sec->origin_y, sec->sector_size);
+    if (c0 < 0)
+      c0 = 0;
+    if (r0 < 0)
+      r0 = 0;
+    if (c1 >= sec->cols)
+      c1 = sec->cols - 1;
+    if (r1 >= sec->rows)
+      r1 = sec->rows - 1;
+    for (int32_t r = r0; r <= r1; r++) {
+      for (int32_t c = c0; c <= c1; c++) {
+        int s = (int)(r * sec->cols + c);
+        if (sec->state[s] != AK_SECTOR_OUT)
+          continue;
+        int k = 0;
+        while (k < AK_SECTOR_READS && sec->reading[k] >= 0)
+          k++;
+        if (k == AK_SECTOR_READS)
+          return; // All slots busy; the rest start on a later update
+        if (!sec->io.read(sec->io.ctx, s, sec->buffers[k], AK_SECTOR_BYTES))
+          return;
+        sec->reading[k] = s;
+        sec->state[s] = AK_SECTOR_READING;
+      }
+    }
+  }
+}
@@ -0,0 +1,157 @@
+#ifndef AK_SECTORS_H
+#define AK_SECTORS_H
+
+#include "ak_scene.h"
+
+/*
+ * Streaming levels larger than one world. The level is a grid of square
+ * sectors, each a list of body records. ak_sectors_update, called between
+ * steps, starts reads for the sectors near the foci before they are needed,
+ * inserts the bodies of finished reads, and writes out sectors left far
+ * behind (with the current state of their bodies) before removing them, so
+ * distant parts of the level keep their state without being simulated.
+ *
+ * All I/O goes through an ak_sector_io_t whose calls only queue work and
+ * never block, e.g. a file and an I/O thread (see src/platforms/pc/
+ * pc_sectors.c). Streamed bodies get the ids
+ *   id_base + sector * AK_MAX_SECTOR_BODIES + k
+ * and belong to that sector, so the range is reserved: any other body given
+ * an id in it is written out and removed with the sector. id_base must be
+ * positive, since new bodies start with id 0. A body that has moved into
+ * another loaded sector is handed over to it (a new id in its range) when
+ * its own sector is written out; if the sector it is in lies near a focus
+ * but is not loaded yet, its own sector stays in until it is.
+ * Tethers and ropes are not streamed; ones attached to an unloaded body are
+ * dropped with it.
+ *
+ * Level file (.akl), all 32-bit little-endian words:
+ *
+ *   header                          AK_SECTOR_HEADER_SIZE
+ *   table    x cols * rows          AK_SECTOR_ENTRY_SIZE each, row-major
+ *   records  per sector             AK_SCENE_BODY_SIZE each (see ak_scene.h)
+ *
+ * Record positions are relative to the top-left corner of their sector, so
+ * a level can extend far beyond the +/-32k px a position can hold.
+ */
+
+#define AK_SECTOR_MAGIC 0x564C4B41u // "AKLV"
+#define AK_SECTOR_VERSION 1
+
+#define AK_SECTOR_HEADER_SIZE 28
+#define AK_SECTOR_ENTRY_SIZE 8
+
+#ifndef AK_MAX_SECTORS
+#define AK_MAX_SECTORS 256
+#endif
+
+// Bodies one sector can hold, including ones saved back into it
+#ifndef AK_MAX_SECTOR_BODIES
+#define AK_MAX_SECTOR_BODIES 64
+#endif
+
+// Sector reads in flight at once
+#ifndef AK_SECTOR_READS
+#define AK_SECTOR_READS 4
+#endif
+
+#define AK_SECTOR_BYTES (AK_MAX_SECTOR_BODIES * AK_SCENE_BODY_SIZE)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  int32_t sector_size;        // Whole pixels
+  int32_t cols, rows;
+  int32_t origin_x, origin_y; // Global pixels of sector 0's top-left corner
+} ak_sector_header_t;
+
+typedef struct {
+  uint32_t offset;     // Of the sector's records in the file
+  uint32_t body_count;
+} ak_sector_entry_t;
+
+void ak_sector_encode_header(uint8_t *out, const ak_sector_header_t *h);
+void ak_sector_decode_header(const uint8_t *in, ak_sector_header_t *h);
+void ak_sector_encode_entry(uint8_t *out, const ak_sector_entry_t *e);
+void ak_sector_decode_entry(const uint8_t *in, ak_sector_entry_t *e);
+
+// poll results that are not byte counts
+#define AK_SECTOR_PENDING -1
+#define AK_SECTOR_FAILED -2
+
+typedef struct {
+  void *ctx;
+  /**
+   * Start reading the sector's records (the last ones written for it, else
+   * the level file's) into dst, at most capacity bytes. Returns 0 if the
+   * read cannot be queued now. Reads must see every earlier write.
+   */
+  int (*read)(void *ctx, int sector, void *dst, uint32_t capacity);
+  // Bytes read once the read is done, else AK_SECTOR_PENDING or _FAILED
+  int32_t (*poll)(void *ctx, int sector);
+  // Queue the sector's new records; data is copied. Returns 0 if it cannot.
+  int (*write)(void *ctx, int sector, const void *data, uint32_t size);
+} ak_sector_io_t;
+
+typedef enum {
+  AK_SECTOR_OUT,     // On disk only
+  AK_SECTOR_READING, // Read in flight
+  AK_SECTOR_IN       // Bodies in the world
+} ak_sector_state_t;
+
+typedef struct {
+  uint32_t loaded, unloaded;     // Sectors
+  uint32_t bodies_in, bodies_out;
+  uint32_t discarded;  // Reads finished after the foci had moved away
+  uint32_t deferred;   // Updates that held a read back for lack of room
+  uint32_t failed;     // Reads the I/O reported failed (retried later) and
+                       // records rejected by ak_scene_body_shape
+  uint32_t moved;      // Bodies handed over to the loaded sector they were in
+  uint32_t dropped;    // Bodies removed unsaved, past AK_MAX_SECTOR_BODIES
+  uint32_t clamped;    // Bodies saved too far from their sector's corner for
+                       // a record; moved to the nearest position that fits
+} ak_sector_stats_t;
+
+typedef struct {
+  int32_t sector_size;
+  int cols, rows;
+  int32_t origin_x, origin_y;
+  int id_base;
+  // Sectors within load_margin px of a focus are read in, and ones beyond
+  // unload_margin px of every focus written out (unload_margin > load_margin
+  // so a sector on the edge does not thrash)
+  int32_t load_margin, unload_margin;
+  ak_sector_io_t io;
+  uint8_t state[AK_MAX_SECTORS]; // ak_sector_state_t
+  int reading[AK_SECTOR_READS];  // Sector of each read slot, -1 if free
+  uint8_t buffers[AK_SECTOR_READS][AK_SECTOR_BYTES];
+  uint8_t scratch[AK_SECTOR_BYTES]; // Records of a sector being written
+  ak_sector_stats_t stats;
+} ak_sectors_t;
+
+/**
+ * Set up streaming for the level whose header is in header (at least
+ * AK_SECTOR_HEADER_SIZE bytes). Every sector starts out; margins default to
+ * half a sector and one sector. Returns 0 if the header is not a level of
+ * this version or has more than AK_MAX_SECTORS sectors, or id_base <= 0.
+ */
+int ak_sectors_init(ak_sectors_t *sectors, const void *header,
+                    ak_sector_io_t io, int id_base);
+/**
+ * Between steps (never during a time-sliced step): insert finished reads,
+ * write out and remove far sectors, and start reads for sectors near the
+ * foci (local positions, as for the LOD).
+ */
+void ak_sectors_update(ak_sectors_t *sectors, ak_world_t *world,
+                       const ak_vec2_t *foci, int focus_count);
+// Sectors with a read in flight
+int ak_sectors_pending(const ak_sectors_t *sectors);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // AK_SECTORS_H
@@ -1,11 +1,42 @@
 #include "demo_bitmap.h"
 #include <stdlib.h>
 
-void demo_bitmap_clear(demo_bitmap_t *bmp, uint16_t color) {
-  int size = bmp->width * bmp->height;
-  for (int i = 0; i < size; i++) {
-    bmp->pixels[i] = color;
+// Two pixels per store. may_alias keeps the wide stores into the 16-bit
+// frame legal under strict aliasing.
+#ifdef __GNUC__
+typedef uint32_t __attribute__((__may_alias__)) demo_pixel_pair_t;
+#else
+typedef uint32_t demo_pixel_pair_t;
+#endif
+
+// Unclipped fill of n pixels starting at p
+static void FillRun(uint16_t *p, int32_t n, uint16_t color) {
+  if (n <= 0)
+    return;
+  if ((uintptr_t)p & 2) {
+    *p++ = color;
+    n--;
   }
+  uint32_t pair = ((uint32_t)color << 16) | color;
+  demo_pixel_pair_t *q = (demo_pixel_pair_t *)p;
+  while (n >= 8) {
+    q[0] = pair;
+    q[1] = pair;
+    q[2] = pair;
+    q[3] = pair;
+    q += 4;
+    n -= 8;
+  }
+  while (n >= 2) {
+    *q++ = pair;
+    n -= 2;
+  }
+  if (n)
+    *(uint16_t *)q = color;
+}
+
+void demo_bitmap_clear(demo_bitmap_t *bmp, uint16_t color) {
+  FillRun(bmp->pixels, (int32_t)bmp->width * bmp->height, color);
 }
 
 void demo_bitmap_draw_pixel(demo_bitmap_t *bmp, int x, int y, uint16_t color) {
@@ -14,12 +45,31 @@ void demo_bitmap_draw_pixel(demo_bitmap_t *bmp, int x, int y, uint16_t color) {
   bmp->pixels[y * bmp->width + x] = color;
 }
 
+void demo_bitmap_fill_span(demo_bitmap_t *bmp, int x0, int x1, int y,
+                           uint16_t color) {
+  if (y < 0 || y >= bmp->height)
+    return;
+  if (x0 < 0)
+    x0 = 0;
+  if (x1 >= bmp->width)
+    x1 = bmp->width - 1;
+  FillRun(bmp->pixels + (int32_t)y * bmp->width + x0, x1 - x0 + 1, color);
+}
+
 void demo_bitmap_draw_rect(demo_bitmap_t *bmp, int x, int y, int w, int h,
                            uint16_t color) {
-  for (int j = y; j < y + h; j++) {
-    for (int i = x; i < x + w; i++) {
-      demo_bitmap_draw_pixel(bmp, i, j, color);
-    }
+  // Clip once, then fill whole rows
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + w > bmp->width ? bmp->width : x + w;
+  int y1 = y + h > bmp->height ? bmp->height : y + h;
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  uint16_t *row = bmp->pixels + (int32_t)y0 * bmp->width + x0;
+  for (int j = y0; j < y1; j++) {
+    FillRun(row, x1 - x0, color);
+    row += bmp->width;
   }
 }
 
@@ -49,6 +99,39 @@ void demo_bitmap_draw_circle(demo_bitmap_t *bmp, int cx, int cy, int r,
   }
 }
 
+// Same midpoint walk as demo_bitmap_draw_circle, emitting each row once.
+// Rows at cy +/- x are filled every step; rows at cy +/- y only when y is
+// about to move on, i.e. at their widest.
+void demo_bitmap_fill_circle(demo_bitmap_t *bmp, int cx, int cy, int r,
+                             uint16_t color) {
+  if (r < 0 || cx + r < 0 || cx - r >= bmp->width || cy + r < 0 ||
+      cy - r >= bmp->height)
+    return;
+
+  int x = 0;
+  int y = r;
+  int d = 3 - 2 * r;
+
+  while (y >= x) {
+    demo_bitmap_fill_span(bmp, cx - y, cx + y, cy + x, color);
+    if (x != 0)
+      demo_bitmap_fill_span(bmp, cx - y, cx + y, cy - x, color);
+
+    if (d > 0) {
+      if (x < y) {
+        demo_bitmap_fill_span(bmp, cx - x, cx + x, cy + y, color);
+        demo_bitmap_fill_span(bmp, cx - x, cx + x, cy - y, color);
+      }
+      x++;
+      y--;
+      d = d + 4 * (x - y) + 10;
+    } else {
+      x++;
+      d = d + 4 * x + 6;
+    }
+  }
+}
+
 void demo_bitmap_draw_line(demo_bitmap_t *bmp, int x0, int y0, int x1, int y1,
                            uint16_t color) {
   int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
@@ -70,3 +153,48 @@ void demo_bitmap_draw_line(demo_bitmap_t *bmp, int x0, int y0, int x1, int y1,
     }
   }
 }
+
+// --- Dirty rectangles ---
+
+void demo_dirty_init(demo_dirty_t *dirty) {
+  dirty->count = 0;
+  dirty->full = 1; // Frame contents unknown until the first full clear
+}
+
+void demo_dirty_add(demo_dirty_t *dirty, demo_bitmap_t *bmp, int x, int y,
+                    int w, int h) {
+  if (dirty->full)
+    return;
+
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + w > bmp->width ? bmp->width : x + w;
+  int y1 = y + h > bmp->height ? bmp->height : y + h;
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  if (dirty->count >= DEMO_DIRTY_MAX_RECTS) {
+    dirty->full = 1;
+    return;
+  }
+  demo_rect_t *r = &dirty->rects[dirty->count++];
+  r->x0 = (int16_t)x0;
+  r->y0 = (int16_t)y0;
+  r->x1 = (int16_t)x1;
+  r->y1 = (int16_t)y1;
+}
+
+void demo_dirty_clear(demo_dirty_t *dirty, demo_bitmap_t *bmp,
+                      uint16_t color) {
+  if (dirty->full) {
+    demo_bitmap_clear(bmp, color);
+  } else {
+    for (int i = 0; i < dirty->count; i++) {
+      demo_rect_t *r = &dirty->rects[i];
+      demo_bitmap_draw_rect(bmp, r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0,
+                            color);
+    }
+  }
+  dirty->count = 0;
+  dirty->full = 0;
+}
@@ -4,19 +4,49 @@
 #include "jag_platform.h"
 #include <stdint.h>
 
+// Max regions tracked per frame before falling back to a full clear
+#ifndef DEMO_DIRTY_MAX_RECTS
+#define DEMO_DIRTY_MAX_RECTS 128
+#endif
+
 typedef struct {
   uint16_t *pixels;
   int width;
   int height;
 } demo_bitmap_t;
 
+typedef struct {
+  int16_t x0, y0, x1, y1; // Half-open [x0, x1) x [y0, y1), already clipped
+} demo_rect_t;
+
+// Tracks the regions drawn in the previous frame so only those need to be
+// cleared before the current frame is drawn, instead of the whole frame.
+typedef struct {
+  demo_rect_t rects[DEMO_DIRTY_MAX_RECTS];
+  int count;
+  int full; // Overflowed (or first frame): next clear wipes everything
+} demo_dirty_t;
+
 void demo_bitmap_clear(demo_bitmap_t *bmp, uint16_t color);
 void demo_bitmap_draw_pixel(demo_bitmap_t *bmp, int x, int y, uint16_t color);
+// Horizontal run from x0 to x1 inclusive, clipped to the bitmap
+void demo_bitmap_fill_span(demo_bitmap_t *bmp, int x0, int x1, int y,
+                           uint16_t color);
 void demo_bitmap_draw_rect(demo_bitmap_t *bmp, int x, int y, int w, int h,
                            uint16_t color);
 void demo_bitmap_draw_circle(demo_bitmap_t *bmp, int cx, int cy, int r,
                              uint16_t color);
+void demo_bitmap_fill_circle(demo_bitmap_t *bmp, int cx, int cy, int r,
+                             uint16_t color);
 void demo_bitmap_draw_line(demo_bitmap_t *bmp, int x0, int y0, int x1, int y1,
                            uint16_t color);
 
+// Dirty-rectangle redraw. Per frame: demo_dirty_clear() erases what was
+// drawn last frame, then demo_dirty_add() each region drawn this frame.
+void demo_dirty_init(demo_dirty_t *dirty);
+void demo_dirty_add(demo_dirty_t *dirty, demo_bitmap_t *bmp, int x, int y,
+                    int w, int h);
+void demo_dirty_clear(demo_dirty_t *dirty, demo_bitmap_t *bmp,
+                      uint16_t color);
+
 #endif // DEMO_BITMAP_H
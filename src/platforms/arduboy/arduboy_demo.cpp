@@ -5,11 +5,19 @@
  */
 
 #include "ak_demo_setup.h"
+#include "ak_draw.h"
 #include "ak_physics.h"
 #include <Arduboy2.h>
 
 Arduboy2 arduboy;
 ak_world_t world;
+// Sized for the standard scene by AK_MAX_DRAW_PRIMS in the build flags
+ak_draw_list_t draw_list;
+
+// Physics work per frame (pairs, tethers, rope links). The standard scene
+// fits in one frame; a bigger pile-up spreads its step over several frames
+// instead of missing vsync.
+static const int32_t kPhysicsBudget = 128;
 
 void setup() {
   arduboy.begin();
@@ -34,34 +42,27 @@ void loop() {
 
   // Physics Parity: Standardize on 60Hz internal steps (matching PC/Playdate).
   ak_fixed_t dt = AK_FIXED_DIV(AK_INT_TO_FIXED(1), AK_INT_TO_FIXED(60));
-  ak_world_step(&world, dt);
+  if (world.step.phase == AK_STEP_IDLE)
+    ak_world_step_begin(&world, dt);
+  if (ak_world_step_continue(&world, kPhysicsBudget))
+    ak_world_step_end(&world);
 
   // Render
   arduboy.clear();
 
-  for (int i = 0; i < world.body_count; i++) {
-    ak_body_t *b = &world.bodies[i];
-    int x = AK_FIXED_TO_INT(b->position.x);
-    int y = AK_FIXED_TO_INT(b->position.y);
+  ak_world_build_draw_list(&world, {{0, 0}, WIDTH, HEIGHT},
+                           {AK_FIXED_ONE, AK_FIXED_ONE}, &draw_list);
+  const ak_draw_prim_t *p = draw_list.prims;
 
-    if (b->shape.type == AK_SHAPE_CIRCLE) {
-      int r = AK_FIXED_TO_INT(b->shape.bounds.circle.radius);
-      arduboy.drawCircle(x, y, r, WHITE);
-    } else if (b->shape.type == AK_SHAPE_AABB) {
-      int w = AK_FIXED_TO_INT(b->shape.bounds.aabb.width);
-      int h = AK_FIXED_TO_INT(b->shape.bounds.aabb.height);
-      arduboy.drawRect(x - w, y - h, w * 2, h * 2, WHITE);
-    }
-  }
+  for (int i = 0; i < draw_list.circle_count; i++, p++)
+    arduboy.drawCircle(p->circle.x, p->circle.y, p->circle.r, WHITE);
 
-  // Draw Tethers
-  for (int i = 0; i < world.tether_count; i++) {
-    ak_tether_t *t = &world.tethers[i];
-    arduboy.drawLine(AK_FIXED_TO_INT(t->a->position.x),
-                     AK_FIXED_TO_INT(t->a->position.y),
-                     AK_FIXED_TO_INT(t->b->position.x),
-                     AK_FIXED_TO_INT(t->b->position.y), WHITE);
-  }
+  for (int i = 0; i < draw_list.rect_count; i++, p++)
+    arduboy.drawRect(p->rect.x, p->rect.y, p->rect.w, p->rect.h, WHITE);
+
+  // Tethers and rope segments
+  for (int i = 0; i < draw_list.line_count; i++, p++)
+    arduboy.drawLine(p->line.x1, p->line.y1, p->line.x2, p->line.y2, WHITE);
 
   arduboy.display();
 }
@@ -1,4 +1,5 @@
 #include "ak_demo_setup.h"
+#include "ak_draw.h"
 #include "ak_physics.h"
 #include "demo_bitmap.h"
 #include "jag_gpu.h"
@@ -8,6 +9,7 @@
 #include <sprite.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdlib.h>
 
 #ifdef JAGUAR
 // Global display and screen pointers (rmvlib types)
@@ -16,6 +18,7 @@ screen *scr; // rmvlib screen structure
 #endif
 
 demo_bitmap_t main_screen;
+demo_dirty_t dirty;
 
 void InitVideo() {
   main_screen.width = SCREEN_WIDTH;
@@ -34,35 +37,56 @@ void InitVideo() {
 
   main_screen.pixels = (uint16_t *)screen_data;
 #endif
+  demo_dirty_init(&dirty);
 }
 
+// Marks the bounding box of a line as drawn this frame
+static void MarkLine(int x1, int y1, int x2, int y2) {
+  int x = x1 < x2 ? x1 : x2;
+  int y = y1 < y2 ? y1 : y2;
+  demo_dirty_add(&dirty, &main_screen, x, y, abs(x2 - x1) + 1,
+                 abs(y2 - y1) + 1);
+}
+
+static ak_draw_list_t draw_list;
+
 void RenderWorld(ak_world_t *world) {
-  demo_bitmap_clear(&main_screen, COL_BLACK);
-
-  for (int i = 0; i < world->body_count; i++) {
-    ak_body_t *b = &world->bodies[i];
-    int x = AK_FIXED_TO_INT(b->position.x);
-    int y = AK_FIXED_TO_INT(b->position.y);
-
-    if (b->shape.type == AK_SHAPE_CIRCLE) {
-      int r = AK_FIXED_TO_INT(b->shape.bounds.circle.radius);
-      demo_bitmap_draw_circle(&main_screen, x, y, r,
-                              b->is_static ? COL_BLUE : COL_RED);
-    } else if (b->shape.type == AK_SHAPE_AABB) {
-      int w = AK_FIXED_TO_INT(b->shape.bounds.aabb.width);
-      int h = AK_FIXED_TO_INT(b->shape.bounds.aabb.height);
-      demo_bitmap_draw_rect(&main_screen, x - w, y - h, w * 2, h * 2,
-                            b->is_static ? COL_GREEN : COL_WHITE);
-    }
+  // Only erase what the previous frame drew. Static bodies are never
+  // erased, so they are redrawn but not tracked.
+  demo_dirty_clear(&dirty, &main_screen, COL_BLACK);
+
+  ak_world_build_draw_list(world,
+                           (ak_draw_viewport_t){{0, 0}, SCREEN_WIDTH,
+                                                SCREEN_HEIGHT},
+                           (ak_vec2_t){AK_FIXED_ONE, AK_FIXED_ONE},
+                           &draw_list);
+  const ak_draw_prim_t *p = draw_list.prims;
+
+  for (int i = 0; i < draw_list.circle_count; i++, p++) {
+    const ak_draw_circle_t *c = &p->circle;
+    int is_static = c->flags & AK_DRAW_STATIC;
+    demo_bitmap_fill_circle(&main_screen, c->x, c->y, c->r,
+                            is_static ? COL_BLUE : COL_RED);
+    if (!is_static)
+      demo_dirty_add(&dirty, &main_screen, c->x - c->r, c->y - c->r,
+                     c->r * 2 + 1, c->r * 2 + 1);
+  }
+
+  for (int i = 0; i < draw_list.rect_count; i++, p++) {
+    const ak_draw_rect_t *r = &p->rect;
+    int is_static = r->flags & AK_DRAW_STATIC;
+    demo_bitmap_draw_rect(&main_screen, r->x, r->y, r->w, r->h,
+                          is_static ? COL_GREEN : COL_WHITE);
+    if (!is_static)
+      demo_dirty_add(&dirty, &main_screen, r->x, r->y, r->w, r->h);
   }
 
-  for (int i = 0; i < world->tether_count; i++) {
-    ak_tether_t *t = &world->tethers[i];
-    int x1 = AK_FIXED_TO_INT(t->a->position.x);
-    int y1 = AK_FIXED_TO_INT(t->a->position.y);
-    int x2 = AK_FIXED_TO_INT(t->b->position.x);
-    int y2 = AK_FIXED_TO_INT(t->b->position.y);
-    demo_bitmap_draw_line(&main_screen, x1, y1, x2, y2, COL_WHITE);
+  // Tethers and rope segments
+  for (int i = 0; i < draw_list.line_count; i++, p++) {
+    const ak_draw_line_t *l = &p->line;
+    demo_bitmap_draw_line(&main_screen, l->x1, l->y1, l->x2, l->y2,
+                          COL_WHITE);
+    MarkLine(l->x1, l->y1, l->x2, l->y2);
   }
 }
 
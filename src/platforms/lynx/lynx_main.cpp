@@ -1,8 +1,18 @@
 #include "lynx_platform.h"
 #include "ak_demo_setup.h"
+#include "ak_draw.h"
 #include "ak_physics.h"
+#include "ak_fixed.hpp"
 
 ak_world_t world;
+static ak_draw_list_t draw_list;
+
+// Physics step (60Hz), folded at compile time
+constexpr ak::fixed kStepDt = ak::fixed(1) / 60;
+
+// Whole 160x102 screen at one pixel per world unit
+constexpr ak_draw_viewport_t kViewport = {{0, 0}, 160, 102};
+constexpr ak_vec2_t kUnitScale = {AK_FIXED_ONE, AK_FIXED_ONE};
 
 int main() {
     // Initialize Lynx hardware
@@ -21,34 +31,25 @@ int main() {
             ak_demo_create_standard_scene(&world);
         }
 
-        // Physics step (60Hz)
-        ak_fixed_t dt = AK_FIXED_DIV(AK_INT_TO_FIXED(1), AK_INT_TO_FIXED(60));
-        ak_world_step(&world, dt);
+        ak_world_step(&world, kStepDt.raw);
 
         // Render
         lynx_clear_screen();
 
-        for (int i = 0; i < world.body_count; i++) {
-            ak_body_t *b = &world.bodies[i];
-            int x = AK_FIXED_TO_INT(b->position.x);
-            int y = AK_FIXED_TO_INT(b->position.y);
-
-            if (b->shape.type == AK_SHAPE_CIRCLE) {
-                int r = AK_FIXED_TO_INT(b->shape.bounds.circle.radius);
-                lynx_draw_circle(x, y, r);
-            } else if (b->shape.type == AK_SHAPE_AABB) {
-                int w = AK_FIXED_TO_INT(b->shape.bounds.aabb.width);
-                int h = AK_FIXED_TO_INT(b->shape.bounds.aabb.height);
-                lynx_draw_rect(x - w, y - h, w * 2, h * 2);
-            }
+        ak_world_build_draw_list(&world, kViewport, kUnitScale, &draw_list);
+        const ak_draw_prim_t *p = draw_list.prims;
+
+        for (int i = 0; i < draw_list.circle_count; i++, p++) {
+            lynx_draw_circle(p->circle.x, p->circle.y, p->circle.r);
+        }
+
+        for (int i = 0; i < draw_list.rect_count; i++, p++) {
+            lynx_draw_rect(p->rect.x, p->rect.y, p->rect.w, p->rect.h);
         }
 
-        for (int i = 0; i < world.tether_count; i++) {
-            ak_tether_t *t = &world.tethers[i];
-            lynx_draw_line(AK_FIXED_TO_INT(t->a->position.x), 
-                           AK_FIXED_TO_INT(t->a->position.y),
-                           AK_FIXED_TO_INT(t->b->position.x), 
-                           AK_FIXED_TO_INT(t->b->position.y));
+        // Tethers and rope segments
+        for (int i = 0; i < draw_list.line_count; i++, p++) {
+            lynx_draw_line(p->line.x1, p->line.y1, p->line.x2, p->line.y2);
         }
 
         lynx_present_screen();
@@ -0,0 +1,123 @@
+#include "lynx_raster.h"
+#include <stdlib.h>
+
+// Half-widths per row for every radius up to LYNX_RASTER_MAX_RADIUS, stored
+// triangularly: radius r starts at r * (r + 1) / 2 and has r + 1 rows.
+constexpr int SPAN_TABLE_SIZE =
+    (LYNX_RASTER_MAX_RADIUS + 1) * (LYNX_RASTER_MAX_RADIUS + 2) / 2;
+static uint8_t span_table[SPAN_TABLE_SIZE];
+static uint8_t span_built[(LYNX_RASTER_MAX_RADIUS + 8) / 8];
+
+// Fills half[0..r] with the widest dx such that dx*dx + dy*dy <= r*r
+static void build_spans(uint8_t *half, int r) {
+    int dx = r;
+    long r2 = (long)r * r;
+    for (int dy = 0; dy <= r; dy++) {
+        long dy2 = (long)dy * dy;
+        while ((long)dx * dx + dy2 > r2) dx--;
+        half[dy] = static_cast<uint8_t>(dx);
+    }
+}
+
+static const uint8_t *circle_spans(int r) {
+    uint8_t *half = &span_table[r * (r + 1) / 2];
+    uint8_t bit = static_cast<uint8_t>(1 << (r & 7));
+    if (!(span_built[r >> 3] & bit)) {
+        build_spans(half, r);
+        span_built[r >> 3] |= bit;
+    }
+    return half;
+}
+
+void lynx_raster_clear(const lynx_surface_t *s, uint8_t color_index) {
+    uint8_t packed = static_cast<uint8_t>((color_index << 4) | (color_index & 0x0F));
+    uint8_t *p = s->pixels;
+    uint16_t n = static_cast<uint16_t>(s->stride * s->height);
+    // Unrolled by 8; the 160x102 frame (8160 bytes) has no remainder
+    for (; n >= 8; n -= 8, p += 8) {
+        p[0] = packed; p[1] = packed; p[2] = packed; p[3] = packed;
+        p[4] = packed; p[5] = packed; p[6] = packed; p[7] = packed;
+    }
+    while (n--) *p++ = packed;
+}
+
+void lynx_raster_plot(const lynx_surface_t *s, int x, int y, uint8_t color_index) {
+    if (x < 0 || y < 0 || x >= s->width || y >= s->height) return;
+    uint8_t *p = s->pixels + y * s->stride + (x >> 1);
+    if ((x & 1) == 0) {
+        *p = (*p & 0x0F) | (color_index << 4);
+    } else {
+        *p = (*p & 0xF0) | (color_index & 0x0F);
+    }
+}
+
+void lynx_raster_span(const lynx_surface_t *s, int x0, int x1, int y, uint8_t color_index) {
+    if (y < 0 || y >= s->height) return;
+    if (x0 < 0) x0 = 0;
+    if (x1 >= s->width) x1 = s->width - 1;
+    if (x0 > x1) return;
+
+    uint8_t lo = color_index & 0x0F;
+    uint8_t *row = s->pixels + y * s->stride;
+
+    // Odd start: only the low nibble of the first byte
+    if (x0 & 1) {
+        row[x0 >> 1] = (row[x0 >> 1] & 0xF0) | lo;
+        x0++;
+    }
+    // Even end: only the high nibble of the last byte
+    if (!(x1 & 1) && x1 >= x0) {
+        row[x1 >> 1] = (row[x1 >> 1] & 0x0F) | (lo << 4);
+        x1--;
+    }
+    // Whole bytes, two pixels each
+    uint8_t packed = static_cast<uint8_t>((lo << 4) | lo);
+    uint8_t *p = row + (x0 >> 1);
+    uint8_t *end = row + ((x1 + 1) >> 1);
+    while (p < end) *p++ = packed;
+}
+
+void lynx_raster_rect(const lynx_surface_t *s, int x, int y, int w, int h, uint8_t color_index) {
+    int y0 = y < 0 ? 0 : y;
+    int y1 = y + h > s->height ? s->height : y + h;
+    for (int py = y0; py < y1; py++) {
+        lynx_raster_span(s, x, x + w - 1, py, color_index);
+    }
+}
+
+void lynx_raster_circle(const lynx_surface_t *s, int x, int y, int r, uint8_t color_index) {
+    if (r < 0) return;
+    if (r > LYNX_RASTER_MAX_RADIUS) {
+        // Too big for the tables (nothing in the demo is); slow path
+        int dx = r;
+        long r2 = (long)r * r;
+        for (int dy = 0; dy <= r; dy++) {
+            while ((long)dx * dx + (long)dy * dy > r2) dx--;
+            lynx_raster_span(s, x - dx, x + dx, y + dy, color_index);
+            if (dy) lynx_raster_span(s, x - dx, x + dx, y - dy, color_index);
+        }
+        return;
+    }
+
+    const uint8_t *half = circle_spans(r);
+    lynx_raster_span(s, x - half[0], x + half[0], y, color_index);
+    for (int dy = 1; dy <= r; dy++) {
+        int hw = half[dy];
+        lynx_raster_span(s, x - hw, x + hw, y + dy, color_index);
+        lynx_raster_span(s, x - hw, x + hw, y - dy, color_index);
+    }
+}
+
+void lynx_raster_line(const lynx_surface_t *s, int x1, int y1, int x2, int y2, uint8_t color_index) {
+    int dx = abs(x2 - x1), sx = x1 < x2 ? 1 : -1;
+    int dy = -abs(y2 - y1), sy = y1 < y2 ? 1 : -1;
+    int err = dx + dy, e2;
+
+    while (1) {
+        lynx_raster_plot(s, x1, y1, color_index);
+        if (x1 == x2 && y1 == y2) break;
+        e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x1 += sx; }
+        if (e2 <= dx) { err += dx; y1 += sy; }
+    }
+}
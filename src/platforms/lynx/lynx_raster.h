@@ -0,0 +1,30 @@
+#ifndef LYNX_RASTER_H
+#define LYNX_RASTER_H
+
+#include <stdint.h>
+
+// 4bpp packed surface: two pixels per byte, even x in the high nibble.
+// Has no Lynx hardware dependencies so it can be built and checked against a
+// plain buffer on the host.
+struct lynx_surface_t {
+    uint8_t *pixels;
+    int width;
+    int height;
+    int stride; // Bytes per row
+};
+
+// Largest radius served from the precomputed span tables; bigger circles
+// fall back to computing their spans on the fly.
+#ifndef LYNX_RASTER_MAX_RADIUS
+#define LYNX_RASTER_MAX_RADIUS 48
+#endif
+
+void lynx_raster_clear(const lynx_surface_t *s, uint8_t color_index);
+void lynx_raster_plot(const lynx_surface_t *s, int x, int y, uint8_t color_index);
+// Horizontal run from x0 to x1 inclusive, clipped to the surface
+void lynx_raster_span(const lynx_surface_t *s, int x0, int x1, int y, uint8_t color_index);
+void lynx_raster_rect(const lynx_surface_t *s, int x, int y, int w, int h, uint8_t color_index);
+void lynx_raster_circle(const lynx_surface_t *s, int x, int y, int r, uint8_t color_index);
+void lynx_raster_line(const lynx_surface_t *s, int x1, int y1, int x2, int y2, uint8_t color_index);
+
+#endif
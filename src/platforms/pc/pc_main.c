@@ -1,82 +1,363 @@
 #include "ak_demo_setup.h"
+#include "ak_draw.h"
+#include "ak_governor.h"
+#include "ak_particles.h"
 #include "ak_physics.h"
+#include "ak_scene.h"
+#include "pc_sectors.h"
+#include "pc_shm.h"
+#include "pc_trace.h"
+#include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <termios.h>
+#include <time.h>
 #include <unistd.h>
 
-// Simple ASCII renderer for PC terminal
-void PrintASCII(ak_world_t *world) {
-  char canvas[20][41];
+// Scene file mapped for the lifetime of the demo, so resets reload from it
+static const void *scene_data = NULL;
+static size_t scene_size = 0;
 
-  // Clear canvas
-  for (int y = 0; y < 20; y++) {
-    for (int x = 0; x < 40; x++) {
-      canvas[y][x] = '.';
+static int MapScene(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    perror(path);
+    return 0;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    fprintf(stderr, "%s: empty or unreadable\n", path);
+    close(fd);
+    return 0;
+  }
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    perror(path);
+    return 0;
+  }
+  scene_data = data;
+  scene_size = (size_t)st.st_size;
+  return 1;
+}
+
+// Optional level of detail around the visible corner of the world (-l)
+static ak_lod_t lod;
+static int lod_radius = 0; // Pixels, 0 = off
+// Steps between Morton reorders of the bodies (-o), 0 = off
+static int sort_interval = 0;
+// Per-step time budget in microseconds for the quality governor (-b), 0 = off
+static ak_governor_t governor;
+static int budget_us = 0;
+static uint64_t level_steps[AK_GOVERNOR_LEVELS];
+
+// Streamed level (-S): the view pans along it and sectors page in and out.
+// The level keeps its state for the whole run, so there is no reset, and no
+// sparks since particles are bounded by the world's size.
+static ak_sectors_t level;
+static pc_sectors_t *level_io = NULL;
+static int32_t view_x, view_y; // Global pixels of the view's top-left corner
+static int view_dir = 1;
+static uint64_t stream_ns, max_stream_ns;
+
+// Local position of the view's top-left corner
+static ak_vec2_t ViewOrigin(const ak_world_t *world) {
+  if (!level_io)
+    return (ak_vec2_t){0, 0};
+  return (ak_vec2_t){AK_INT_TO_FIXED(view_x - world->origin_x),
+                     AK_INT_TO_FIXED(view_y - world->origin_y)};
+}
+
+static int ResetScene(ak_world_t *world) {
+  if (level_io) {
+    // Empty; the bodies stream in around the view
+    ak_world_init(world, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
+                  (ak_vec2_t){0, AK_INT_TO_FIXED(50)});
+  } else if (!scene_data) {
+    ak_demo_create_standard_scene(world);
+  } else {
+    ak_scene_result_t res = ak_scene_load(world, scene_data, scene_size);
+    if (res != AK_SCENE_OK) {
+      fprintf(stderr, "Scene load failed (error %d)\n", (int)res);
+      return 0;
     }
-    canvas[y][40] = '\0';
   }
+  // Loading re-initializes the world, which detaches the LOD
+  if (lod_radius > 0) {
+    ak_vec2_t view = ViewOrigin(world);
+    ak_lod_init(&lod, AK_INT_TO_FIXED(lod_radius));
+    lod.foci[0] = (ak_vec2_t){view.x + AK_INT_TO_FIXED(160),
+                              view.y + AK_INT_TO_FIXED(120)};
+    lod.focus_count = 1;
+    ak_world_set_lod(world, &lod);
+  }
+  ak_world_set_sort_interval(world, sort_interval);
+  if (budget_us > 0)
+    ak_governor_init(&governor, world, budget_us);
+  return 1;
+}
 
-  for (int i = 0; i < world->body_count; i++) {
-    ak_body_t *b = &world->bodies[i];
+static ak_particles_t sparks;
 
-    // Convert world coords to canvas coords (World: 320x240, Canvas: 40x20)
-    int cx = AK_FIXED_TO_INT(b->position.x) / 8;
-    int cy = AK_FIXED_TO_INT(b->position.y) / 12;
+// Fountain of short-lived sparks from the top center of the world
+static void EmitSparks(ak_world_t *world, int count) {
+  static uint32_t seed = 1;
+  ak_vec2_t origin = {world->width / 2, AK_INT_TO_FIXED(10)};
+  for (int i = 0; i < count; i++) {
+    seed = seed * 1103515245u + 12345u;
+    ak_fixed_t vx = (ak_fixed_t)((seed >> 8) % AK_INT_TO_FIXED(160)) -
+                    AK_INT_TO_FIXED(80);
+    seed = seed * 1103515245u + 12345u;
+    ak_fixed_t vy = -(ak_fixed_t)((seed >> 8) % AK_INT_TO_FIXED(60));
+    ak_particles_emit(&sparks, origin, (ak_vec2_t){vx, vy}, 300);
+  }
+}
 
-    if (b->shape.type == AK_SHAPE_AABB) {
-      int half_w = AK_FIXED_TO_INT(b->shape.bounds.aabb.width) / 8;
-      int half_h = AK_FIXED_TO_INT(b->shape.bounds.aabb.height) / 12;
+#define CANVAS_W 40
+#define CANVAS_H 20
 
-      int x1 = cx - half_w;
-      int x2 = cx + half_w;
-      int y1 = cy - half_h;
-      int y2 = cy + half_h;
+// Simple ASCII renderer for PC terminal: one character per 8x12 world units
+static void BuildCanvas(ak_world_t *world,
+                        char canvas[CANVAS_H][CANVAS_W + 1]) {
+  // Clear canvas
+  for (int y = 0; y < CANVAS_H; y++) {
+    for (int x = 0; x < CANVAS_W; x++) {
+      canvas[y][x] = '.';
+    }
+    canvas[y][CANVAS_W] = '\0';
+  }
+
+  // Tilemap, sampled at each cell center
+  ak_vec2_t view = ViewOrigin(world);
+  const ak_tilemap_t *map = &world->tilemap;
+  if (map->tiles) {
+    for (int y = 0; y < CANVAS_H; y++) {
+      for (int x = 0; x < CANVAS_W; x++) {
+        ak_fixed_t wx = AK_INT_TO_FIXED(x * 8 + 4) + view.x - map->origin.x;
+        ak_fixed_t wy = AK_INT_TO_FIXED(y * 12 + 6) + view.y - map->origin.y;
+        int tx = AK_FIXED_TO_INT(AK_FIXED_DIV(wx, map->tile_size)) +
+                 map->origin_tx;
+        int ty = AK_FIXED_TO_INT(AK_FIXED_DIV(wy, map->tile_size)) +
+                 map->origin_ty;
+        if (tx >= 0 && ty >= 0 && tx < map->width && ty < map->height &&
+            map->tiles[ty * map->width + tx]) {
+          canvas[y][x] = '=';
+        }
+      }
+    }
+  }
 
-      char fill = b->is_static ? '#' : '[';
+  // Canvas cells are 8x12 world units
+  static ak_draw_list_t list;
+  ak_world_build_draw_list(
+      world, (ak_draw_viewport_t){view, CANVAS_W, CANVAS_H},
+      (ak_vec2_t){AK_FIXED_ONE / 8, AK_FIXED_ONE / 12}, &list);
+  const ak_draw_prim_t *p = list.prims;
 
-      for (int y = y1; y <= y2; y++) {
-        for (int x = x1; x <= x2; x++) {
-          if (x >= 0 && x < 40 && y >= 0 && y < 20) {
-            canvas[y][x] = fill;
-          }
+  for (int i = 0; i < list.circle_count; i++, p++) {
+    const ak_draw_circle_t *c = &p->circle;
+    for (int y = c->y - c->r; y <= c->y + c->r; y++) {
+      for (int x = c->x - c->r; x <= c->x + c->r; x++) {
+        if (x >= 0 && x < CANVAS_W && y >= 0 && y < CANVAS_H) {
+          canvas[y][x] = 'O';
         }
       }
-    } else if (b->shape.type == AK_SHAPE_CIRCLE) {
-      int r = AK_FIXED_TO_INT(b->shape.bounds.circle.radius) / 8;
-      if (r < 1)
-        r = 0;
-
-      for (int y = cy - r; y <= cy + r; y++) {
-        for (int x = cx - r; x <= cx + r; x++) {
-          if (x >= 0 && x < 40 && y >= 0 && y < 20) {
-            canvas[y][x] = 'O';
-          }
+    }
+  }
+
+  for (int i = 0; i < list.rect_count; i++, p++) {
+    const ak_draw_rect_t *r = &p->rect;
+    char fill = (r->flags & AK_DRAW_STATIC) ? '#' : '[';
+    for (int y = r->y; y <= r->y + r->h; y++) {
+      for (int x = r->x; x <= r->x + r->w; x++) {
+        if (x >= 0 && x < CANVAS_W && y >= 0 && y < CANVAS_H) {
+          canvas[y][x] = fill;
         }
       }
     }
   }
 
-  printf("\033[H\033[J"); // Clear screen
-  for (int y = 0; y < 20; y++) {
-    for (int x = 0; x < 40; x++) {
-      putchar(canvas[y][x]);
+  // Rope nodes are the segment ends; tethers are not drawn
+  for (int i = 0; i < list.line_count; i++, p++) {
+    const ak_draw_line_t *l = &p->line;
+    if (!(l->flags & AK_DRAW_ROPE))
+      continue;
+    int ends[2][2] = {{l->x1, l->y1}, {l->x2, l->y2}};
+    for (int e = 0; e < 2; e++) {
+      int x = ends[e][0], y = ends[e][1];
+      if (x >= 0 && x < CANVAS_W && y >= 0 && y < CANVAS_H &&
+          canvas[y][x] == '.') {
+        canvas[y][x] = '*';
+      }
+    }
+  }
+
+  for (int i = 0; i < sparks.count; i++) {
+    int x = AK_FIXED_TO_INT(sparks.x[i] - view.x) / 8;
+    int y = AK_FIXED_TO_INT(sparks.y[i] - view.y) / 12;
+    if (x >= 0 && x < CANVAS_W && y >= 0 && y < CANVAS_H &&
+        canvas[y][x] == '.') {
+      canvas[y][x] = ',';
     }
-    putchar('\n');
   }
 }
 
-int main() {
-  ak_world_t world;
-  ak_world_init(
-      &world, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
-      (ak_vec2_t){0, 0}); // Initialized with 0 gravity, demo setup will set it
-  ak_demo_create_standard_scene(&world);
+// Terminal output for one frame, sent with a single write
+static char out[16384];
+static size_t out_len;
 
-  // Physics Parity: Standardize on 60Hz internal steps.
-  ak_fixed_t dt = AK_INT_TO_FIXED(1) / 60; // 1/60th second
+static void Emit(const char *text, size_t len) {
+  if (len > sizeof(out) - out_len)
+    len = sizeof(out) - out_len;
+  memcpy(out + out_len, text, len);
+  out_len += len;
+}
+
+static void EmitText(const char *text) { Emit(text, strlen(text)); }
 
+static void EmitMove(int row, int col) {
+  char seq[16];
+  Emit(seq, (size_t)snprintf(seq, sizeof(seq), "\033[%d;%dH", row + 1,
+                             col + 1));
+}
+
+static void Flush(void) {
+  const char *p = out;
+  while (out_len > 0) {
+    ssize_t n = write(STDOUT_FILENO, p, out_len);
+    if (n <= 0)
+      break;
+    p += n;
+    out_len -= (size_t)n;
+  }
+  out_len = 0;
+}
+
+// What the terminal shows, for the diff renderer
+static char shown[CANVAS_H][CANVAS_W + 1];
+static char shown_status[128];
+static int shown_valid = 0;
+
+/*
+ * Draws a frame. With full set, clears the screen and redraws everything
+ * (the original behavior); otherwise only cells that changed since the last
+ * frame are sent, with a cursor move only where a run of changes breaks.
+ */
+static void Present(const char canvas[CANVAS_H][CANVAS_W + 1],
+                    const char *status, int full) {
+  if (full || !shown_valid) {
+    EmitText("\033[H\033[J"); // Clear screen
+    if (!full)
+      EmitText("\033[?25l"); // Hide the cursor; it would flicker between runs
+    for (int y = 0; y < CANVAS_H; y++) {
+      Emit(canvas[y], CANVAS_W);
+      Emit("\n", 1);
+    }
+    EmitText(status);
+    Emit("\n", 1);
+  } else {
+    int cursor_y = -1, cursor_x = -1;
+    for (int y = 0; y < CANVAS_H; y++) {
+      for (int x = 0; x < CANVAS_W; x++) {
+        if (canvas[y][x] == shown[y][x])
+          continue;
+        if (y != cursor_y || x != cursor_x)
+          EmitMove(y, x);
+        Emit(&canvas[y][x], 1);
+        cursor_y = y;
+        cursor_x = x + 1;
+      }
+    }
+    if (strcmp(status, shown_status) != 0) {
+      EmitMove(CANVAS_H, 0);
+      EmitText(status);
+      EmitText("\033[K"); // Erase the rest of a longer previous status
+    }
+    EmitMove(CANVAS_H + 1, 0); // Park the cursor below the frame
+  }
+  memcpy(shown, canvas, sizeof(shown));
+  snprintf(shown_status, sizeof(shown_status), "%s", status);
+  shown_valid = 1;
+  Flush();
+}
+
+static uint64_t NowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void SleepUntil(uint64_t ns) {
+  struct timespec ts = {(time_t)(ns / 1000000000u),
+                        (long)(ns % 1000000000u)};
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    ;
+}
+
+/*
+ * Pan the view one step along the level (back and forth), keep the origin
+ * near it, and let the sectors follow. Runs between steps, where inserting
+ * and removing bodies is allowed.
+ */
+static void Stream(ak_world_t *world) {
+  int32_t level_w = level.cols * level.sector_size;
+  int32_t level_h = level.rows * level.sector_size;
+  view_x += 2 * view_dir;
+  if (view_x <= level.origin_x || view_x + 320 >= level.origin_x + level_w)
+    view_dir = -view_dir;
+  view_y = level.origin_y + (level_h > 240 ? level_h - 240 : 0);
+
+  ak_vec2_t view = ViewOrigin(world);
+  ak_vec2_t focus = {view.x + AK_INT_TO_FIXED(160),
+                     view.y + AK_INT_TO_FIXED(120)};
+  int32_t dx, dy;
+  if (ak_world_recenter(world, focus, &dx, &dy)) {
+    ak_particles_shift(&sparks, dx, dy);
+    focus.x -= AK_INT_TO_FIXED(dx);
+    focus.y -= AK_INT_TO_FIXED(dy);
+  }
+  if (world->lod)
+    lod.foci[0] = focus;
+
+  uint64_t start = NowNs();
+  ak_sectors_update(&level, world, &focus, 1);
+  uint64_t ns = NowNs() - start;
+  stream_ns += ns;
+  if (ns > max_stream_ns)
+    max_stream_ns = ns;
+}
+
+// One step of everything the demo simulates, plus the optional outputs
+static void Step(ak_world_t *world, ak_fixed_t dt, uint64_t step,
+                 pc_shm_t *mirror, pc_trace_t *trace) {
+  if (level_io)
+    Stream(world);
+  uint64_t start = budget_us ? NowNs() : 0;
+  ak_world_step(world, dt);
+  if (budget_us) {
+    int32_t us = (int32_t)((NowNs() - start) / 1000u);
+    level_steps[ak_governor_update(&governor, world, us)]++;
+  }
+  ak_particles_step(&sparks, world, dt);
+  if (mirror)
+    pc_shm_publish(mirror, world, step);
+  if (trace)
+    pc_trace_record(trace, world, step);
+}
+
+/*
+ * Steps and draws at rate frames per second (0 = as fast as possible) until
+ * Q is pressed. Frames are paced against absolute deadlines on the
+ * monotonic clock, so time spent stepping and drawing is not added on top of
+ * the frame period and the rate does not drift.
+ */
+static void RunInteractive(ak_world_t *world, ak_fixed_t dt, int rate,
+                           int full_redraw, uint64_t *step, pc_shm_t *mirror,
+                           pc_trace_t *trace) {
   // Set non-blocking input
   struct termios oldt, newt;
   tcgetattr(STDIN_FILENO, &oldt);
@@ -86,25 +367,198 @@ int main() {
   int oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
   fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
 
+  uint64_t period = rate > 0 ? 1000000000u / (uint64_t)rate : 0;
+  uint64_t deadline = NowNs();
   while (1) {
     int ch = getchar();
-    if (ch == 'r' || ch == 'R') {
-      ak_demo_create_standard_scene(&world);
+    if ((ch == 'r' || ch == 'R') && !level_io) {
+      ResetScene(world);
+      sparks.count = 0;
+    } else if ((ch == 'p' || ch == 'P') && !level_io) {
+      EmitSparks(world, 200);
     } else if (ch == 'q' || ch == 'Q') {
       break;
     }
 
-    ak_world_step(&world, dt);
-    PrintASCII(&world);
-    printf("Alpha Kinetics PC Demo - Bodies: %d, Tethers: %d (R to reset, Q to "
-           "quit)\n",
-           world.body_count, world.tether_count);
-    usleep(16666);
+    Step(world, dt, ++*step, mirror, trace);
+
+    char canvas[CANVAS_H][CANVAS_W + 1];
+    char status[128];
+    BuildCanvas(world, canvas);
+    int len = snprintf(status, sizeof(status),
+                       "Alpha Kinetics PC Demo - Bodies: %d, Tethers: %d, "
+                       "Particles: %d (P sparks, R reset, Q quit)",
+                       world->body_count, world->tether_count, sparks.count);
+    if (budget_us && len > 0 && (size_t)len < sizeof(status))
+      len += snprintf(status + len, sizeof(status) - (size_t)len,
+                      " Quality %d, %d us", governor.level,
+                      (int)governor.average);
+    if (level_io && len > 0 && (size_t)len < sizeof(status))
+      snprintf(status + len, sizeof(status) - (size_t)len, " x %ld",
+               (long)view_x);
+    Present(canvas, status, full_redraw);
+
+    if (period) {
+      deadline += period;
+      uint64_t now = NowNs();
+      if (now < deadline)
+        SleepUntil(deadline);
+      else if (now - deadline > 4 * period)
+        deadline = now; // Far behind (suspended?): resync, don't sprint
+    }
   }
 
   // Restore terminal
+  if (!full_redraw) {
+    EmitText("\033[?25h");
+    Flush();
+  }
   tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
   fcntl(STDIN_FILENO, F_SETFL, oldf);
+}
 
+static void Usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-m mirror_name] [-t trace.akt] [-H steps] [-f] "
+          "[-r fps] [-l lod_radius] [-o sort_steps] [-b budget_us] "
+          "[-S level.akl | scene.aks]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  static ak_world_t world; // Large with the PC body limits; keep off the stack
+  ak_world_init(
+      &world, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
+      (ak_vec2_t){0, 0}); // Initialized with 0 gravity, demo setup will set it
+
+  // -m mirrors into shared memory, -t records a trace, -H runs that many
+  // steps without a terminal, -f redraws every frame in full instead of
+  // sending changed cells, -r sets the frame rate (0 = unpaced), -l steps
+  // bodies farther than that many pixels from the view at reduced rates,
+  // -o reorders the bodies along a Morton curve every that many steps,
+  // -b lowers simulation quality to keep steps within that many us, -S
+  // streams a level from disk around a panning view
+  const char *scene_path = NULL, *mirror_name = NULL, *trace_path = NULL;
+  const char *level_path = NULL;
+  long headless_steps = 0;
+  int full_redraw = 0, rate = 60;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+      mirror_name = argv[++i];
+    } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+      trace_path = argv[++i];
+    } else if (strcmp(argv[i], "-H") == 0 && i + 1 < argc) {
+      headless_steps = atol(argv[++i]);
+    } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+      rate = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+      lod_radius = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+      budget_us = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+      sort_interval = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "-S") == 0 && i + 1 < argc) {
+      level_path = argv[++i];
+    } else if (strcmp(argv[i], "-f") == 0) {
+      full_redraw = 1;
+    } else if (argv[i][0] != '-') {
+      scene_path = argv[i];
+    } else {
+      Usage(argv[0]);
+      return 2;
+    }
+  }
+  if (headless_steps < 0 || rate < 0 || lod_radius < 0 ||
+      sort_interval < 0 || budget_us < 0 || (level_path && scene_path)) {
+    Usage(argv[0]);
+    return 2;
+  }
+  if (scene_path && !MapScene(scene_path))
+    return 1;
+  if (level_path) {
+    if (!(level_io = pc_sectors_open(level_path, &level, 1)))
+      return 1;
+    view_x = level.origin_x;
+  }
+  if (!ResetScene(&world))
+    return 1;
+
+  // Optional live mirror for ak_shm_view
+  pc_shm_t *mirror = NULL;
+  if (mirror_name && !(mirror = pc_shm_create(mirror_name)))
+    return 1;
+  // Optional per-step body trace, written in the background
+  pc_trace_t *trace = NULL;
+  if (trace_path && !(trace = pc_trace_open(trace_path, 64)))
+    return 1;
+  uint64_t step = 0;
+  ak_particles_init(&sparks, AK_INT_TO_FIXED(1) / 2);
+
+  // Physics Parity: Standardize on 60Hz internal steps.
+  ak_fixed_t dt = AK_INT_TO_FIXED(1) / 60; // 1/60th second
+
+  if (headless_steps > 0) {
+    // No terminal: step as fast as possible and report throughput
+    uint64_t start = NowNs();
+    while (step < (uint64_t)headless_steps)
+      Step(&world, dt, ++step, mirror, trace);
+    double seconds = (double)(NowNs() - start) / 1e9;
+    printf("%ld steps in %.3f s: %.0f steps/s, %.2f us/step "
+           "(%d bodies, %d tethers)\n",
+           headless_steps, seconds, (double)headless_steps / seconds,
+           seconds * 1e6 / (double)headless_steps, world.body_count,
+           world.tether_count);
+    if (world.lod) {
+      printf("LOD tiers:");
+      for (int t = 0; t < AK_LOD_TIERS; t++)
+        printf(" %d", lod.tier_counts[t]);
+      printf(" bodies\n");
+    }
+    if (budget_us) {
+      printf("Quality levels (steps at 0..%d):", AK_GOVERNOR_LEVELS - 1);
+      for (int q = 0; q < AK_GOVERNOR_LEVELS; q++)
+        printf(" %llu", (unsigned long long)level_steps[q]);
+      printf(", %u changes\n", (unsigned)governor.changes);
+    }
+    if (level_io) {
+      const ak_sector_stats_t *ss = &level.stats;
+      printf("Sectors: %u loaded, %u unloaded (%u bodies in, %u out), "
+             "%u discarded, %u deferred, %u failed; bodies %u moved, "
+             "%u dropped, %u clamped; update %.2f us/step (max %.2f)\n",
+             (unsigned)ss->loaded, (unsigned)ss->unloaded,
+             (unsigned)ss->bodies_in, (unsigned)ss->bodies_out,
+             (unsigned)ss->discarded, (unsigned)ss->deferred,
+             (unsigned)ss->failed, (unsigned)ss->moved,
+             (unsigned)ss->dropped, (unsigned)ss->clamped,
+             stream_ns / 1000.0 / (double)headless_steps,
+             max_stream_ns / 1000.0);
+    }
+  } else {
+    RunInteractive(&world, dt, rate, full_redraw, &step, mirror, trace);
+  }
+
+  if (mirror)
+    pc_shm_destroy(mirror, mirror_name);
+  if (level_io) {
+    pc_sectors_stats_t ls;
+    pc_sectors_close(level_io, &ls);
+    printf("Level I/O: %llu reads (%llu bytes, max %.2f ms, %llu truncated), "
+           "%llu writes (%llu bytes)\n",
+           (unsigned long long)ls.reads, (unsigned long long)ls.bytes_read,
+           ls.max_read_ns / 1e6, (unsigned long long)ls.truncated,
+           (unsigned long long)ls.writes, (unsigned long long)ls.bytes_written);
+  }
+  if (trace) {
+    pc_trace_stats_t ts;
+    pc_trace_close(trace, &ts);
+    uint64_t calls = ts.recorded + ts.dropped;
+    printf("Trace: %llu steps (%llu dropped), %llu -> %llu bytes, "
+           "%.2f us/step recording (max %.2f)\n",
+           (unsigned long long)ts.recorded, (unsigned long long)ts.dropped,
+           (unsigned long long)ts.raw_bytes,
+           (unsigned long long)ts.bytes_written,
+           calls ? ts.record_ns / 1000.0 / (double)calls : 0.0,
+           ts.max_record_ns / 1000.0);
+  }
   return 0;
 }
@@ -0,0 +1,219 @@
+#include "pc_sectors.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static uint64_t NowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+// --- Worker ---
+
+// Sets *truncated if the sector holds more than capacity bytes; only the
+// whole records that fit are read
+static int32_t ReadSector(pc_sectors_t *t, int s, uint8_t *dst,
+                          uint32_t capacity, int *truncated) {
+  FILE *f = t->level;
+  long offset = (long)t->entries[s].offset;
+  uint32_t size = t->entries[s].body_count * AK_SCENE_BODY_SIZE;
+  if (t->saved_offset[s] >= 0) {
+    f = t->saved;
+    offset = t->saved_offset[s];
+    size = t->saved_size[s];
+  }
+  *truncated = size > capacity;
+  if (size > capacity)
+    size = capacity - capacity % AK_SCENE_BODY_SIZE;
+  if (size && (fseek(f, offset, SEEK_SET) != 0 ||
+               fread(dst, 1, size, f) != size))
+    return AK_SECTOR_FAILED;
+  return (int32_t)size;
+}
+
+// Appends; the old copy stays in the file unreferenced
+static void WriteSector(pc_sectors_t *t, int s, const uint8_t *data,
+                        uint32_t size) {
+  if (fseek(t->saved, 0, SEEK_END) != 0)
+    return;
+  long offset = ftell(t->saved);
+  if (offset < 0 || fwrite(data, 1, size, t->saved) != size)
+    return; // The sector reads back as it was last saved
+  t->saved_offset[s] = offset;
+  t->saved_size[s] = size;
+}
+
+static void *WorkerThread(void *arg) {
+  pc_sectors_t *t = (pc_sectors_t *)arg;
+  for (;;) {
+    pthread_mutex_lock(&t->lock);
+    while (!t->count && !t->closing)
+      pthread_cond_wait(&t->wake, &t->lock);
+    if (!t->count) {
+      pthread_mutex_unlock(&t->lock);
+      break; // Closing with nothing left
+    }
+    pc_sectors_request_t r = t->queue[t->head];
+    pthread_mutex_unlock(&t->lock);
+
+    int32_t got = 0;
+    int truncated = 0;
+    if (r.write) {
+      WriteSector(t, r.sector, r.data, r.size);
+      free(r.data);
+    } else {
+      got = ReadSector(t, r.sector, r.data, r.size, &truncated);
+    }
+
+    pthread_mutex_lock(&t->lock);
+    t->head = (t->head + 1) % PC_SECTORS_QUEUE;
+    t->count--;
+    if (r.write) {
+      t->stats.writes++;
+      t->stats.bytes_written += r.size;
+    } else {
+      uint64_t ns = NowNs() - r.queued_ns;
+      t->result[r.sector] = got;
+      t->stats.reads++;
+      t->stats.truncated += (uint64_t)truncated;
+      t->stats.bytes_read += got > 0 ? (uint64_t)got : 0;
+      if (ns > t->stats.max_read_ns)
+        t->stats.max_read_ns = ns;
+    }
+    pthread_mutex_unlock(&t->lock);
+  }
+  return NULL;
+}
+
+// --- ak_sector_io_t ---
+
+// Caller holds the lock
+static int Push(pc_sectors_t *t, int s, int write, uint8_t *data,
+                uint32_t size) {
+  if (t->count == PC_SECTORS_QUEUE || t->closing)
+    return 0;
+  pc_sectors_request_t *r =
+      &t->queue[(t->head + t->count) % PC_SECTORS_QUEUE];
+  r->sector = s;
+  r->write = write;
+  r->data = data;
+  r->size = size;
+  r->queued_ns = NowNs();
+  t->count++;
+  pthread_cond_signal(&t->wake);
+  return 1;
+}
+
+static int Read(void *ctx, int s, void *dst, uint32_t capacity) {
+  pc_sectors_t *t = (pc_sectors_t *)ctx;
+  if (s < 0 || s >= t->sector_count)
+    return 0;
+  pthread_mutex_lock(&t->lock);
+  int ok = Push(t, s, 0, (uint8_t *)dst, capacity);
+  if (ok)
+    t->result[s] = AK_SECTOR_PENDING;
+  pthread_mutex_unlock(&t->lock);
+  return ok;
+}
+
+static int32_t Poll(void *ctx, int s) {
+  pc_sectors_t *t = (pc_sectors_t *)ctx;
+  pthread_mutex_lock(&t->lock);
+  int32_t got = t->result[s];
+  pthread_mutex_unlock(&t->lock);
+  return got;
+}
+
+static int Write(void *ctx, int s, const void *data, uint32_t size) {
+  pc_sectors_t *t = (pc_sectors_t *)ctx;
+  if (s < 0 || s >= t->sector_count)
+    return 0;
+  uint8_t *copy = (uint8_t *)malloc(size ? size : 1);
+  if (!copy)
+    return 0;
+  memcpy(copy, data, size);
+  pthread_mutex_lock(&t->lock);
+  int ok = Push(t, s, 1, copy, size);
+  pthread_mutex_unlock(&t->lock);
+  if (!ok)
+    free(copy);
+  return ok;
+}
+
+// --- Open / close ---
+
+static void FreeSectors(pc_sectors_t *t) {
+  if (t->level)
+    fclose(t->level);
+  if (t->saved)
+    fclose(t->saved);
+  free(t->entries);
+  free(t->saved_offset);
+  free(t->saved_size);
+  free(t);
+}
+
+pc_sectors_t *pc_sectors_open(const char *path, ak_sectors_t *sectors,
+                              int id_base) {
+  pc_sectors_t *t = (pc_sectors_t *)calloc(1, sizeof(pc_sectors_t));
+  if (!t)
+    return NULL;
+  t->level = fopen(path, "rb");
+  if (!t->level) {
+    perror(path);
+    free(t);
+    return NULL;
+  }
+
+  uint8_t header[AK_SECTOR_HEADER_SIZE];
+  ak_sector_io_t io = {t, Read, Poll, Write};
+  if (fread(header, 1, sizeof(header), t->level) != sizeof(header) ||
+      !ak_sectors_init(sectors, header, io, id_base)) {
+    fprintf(stderr, "%s: not a level, or more than %d sectors\n", path,
+            AK_MAX_SECTORS);
+    FreeSectors(t);
+    return NULL;
+  }
+  t->sector_count = sectors->cols * sectors->rows;
+  t->entries =
+      (ak_sector_entry_t *)malloc(t->sector_count * sizeof(ak_sector_entry_t));
+  t->saved_offset = (long *)malloc(t->sector_count * sizeof(long));
+  t->saved_size = (uint32_t *)malloc(t->sector_count * sizeof(uint32_t));
+  t->saved = tmpfile();
+  if (!t->entries || !t->saved_offset || !t->saved_size || !t->saved) {
+    fprintf(stderr, "%s: cannot set up sector storage\n", path);
+    FreeSectors(t);
+    return NULL;
+  }
+  for (int s = 0; s < t->sector_count; s++) {
+    uint8_t entry[AK_SECTOR_ENTRY_SIZE];
+    if (fread(entry, 1, sizeof(entry), t->level) != sizeof(entry)) {
+      fprintf(stderr, "%s: truncated sector table\n", path);
+      FreeSectors(t);
+      return NULL;
+    }
+    ak_sector_decode_entry(entry, &t->entries[s]);
+    t->saved_offset[s] = -1;
+  }
+  for (int s = 0; s < AK_MAX_SECTORS; s++)
+    t->result[s] = AK_SECTOR_FAILED;
+
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->wake, NULL);
+  pthread_create(&t->thread, NULL, WorkerThread, t);
+  return t;
+}
+
+void pc_sectors_close(pc_sectors_t *t, pc_sectors_stats_t *stats) {
+  pthread_mutex_lock(&t->lock);
+  t->closing = 1;
+  pthread_cond_signal(&t->wake);
+  pthread_mutex_unlock(&t->lock);
+  pthread_join(t->thread, NULL);
+  pthread_mutex_destroy(&t->lock);
+  pthread_cond_destroy(&t->wake);
+  if (stats)
+    *stats = t->stats;
+  FreeSectors(t);
+}
@@ -0,0 +1,62 @@
+#ifndef PC_SECTORS_H
+#define PC_SECTORS_H
+
+#include "ak_sectors.h"
+#include <pthread.h>
+#include <stdio.h>
+
+/*
+ * Sector I/O for ak_sectors on a file and a worker thread. The physics
+ * thread only queues requests and polls results; the worker reads records
+ * from the level file, or from a scratch file once a sector has been written
+ * out, so the level file itself is never modified. Requests run in order,
+ * which makes every read see the writes queued before it.
+ */
+
+#define PC_SECTORS_QUEUE 32
+
+typedef struct {
+  int sector;
+  int write;     // Else a read
+  uint8_t *data; // Read: destination. Write: malloc'd copy, freed when done
+  uint32_t size; // Read: capacity
+  uint64_t queued_ns;
+} pc_sectors_request_t;
+
+typedef struct {
+  uint64_t reads, writes;
+  uint64_t bytes_read, bytes_written;
+  uint64_t max_read_ns; // Longest read, queued to done
+  uint64_t truncated;   // Reads of sectors larger than the capacity given
+} pc_sectors_stats_t;
+
+typedef struct {
+  FILE *level;
+  FILE *saved; // Scratch file of written-out sectors
+  int sector_count;
+  ak_sector_entry_t *entries;
+  // Latest written copy of each sector, offset -1 if none; worker only
+  long *saved_offset;
+  uint32_t *saved_size;
+  // Guarded by lock
+  pc_sectors_request_t queue[PC_SECTORS_QUEUE];
+  int head, count;
+  int32_t result[AK_MAX_SECTORS]; // Bytes, or AK_SECTOR_PENDING / _FAILED
+  int closing;
+  pc_sectors_stats_t stats;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+} pc_sectors_t;
+
+/**
+ * Open a level and set up sectors to stream from it, with streamed body ids
+ * starting at id_base. Returns NULL if the file is missing or not a level
+ * ak_sectors accepts.
+ */
+pc_sectors_t *pc_sectors_open(const char *path, ak_sectors_t *sectors,
+                              int id_base);
+// Finish queued requests, stop the worker and close. Fills *stats if non-NULL.
+void pc_sectors_close(pc_sectors_t *io, pc_sectors_stats_t *stats);
+
+#endif // PC_SECTORS_H
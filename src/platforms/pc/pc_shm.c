@@ -0,0 +1,148 @@
+#include "pc_shm.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// POSIX segment names start with a single slash
+static void SegmentName(char *out, size_t size, const char *name) {
+  snprintf(out, size, "/%s", name[0] == '/' ? name + 1 : name);
+}
+
+pc_shm_t *pc_shm_create(const char *name) {
+  char path[256];
+  SegmentName(path, sizeof(path), name);
+  shm_unlink(path); // Start clean if a previous run crashed
+  int fd = shm_open(path, O_CREAT | O_RDWR, 0644);
+  if (fd < 0) {
+    perror(path);
+    return NULL;
+  }
+  if (ftruncate(fd, sizeof(pc_shm_t)) != 0) {
+    perror(path);
+    close(fd);
+    shm_unlink(path);
+    return NULL;
+  }
+  void *mem =
+      mmap(NULL, sizeof(pc_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    perror(path);
+    shm_unlink(path);
+    return NULL;
+  }
+
+  // ftruncate zero-fills, so all frames start even (readable) and empty
+  pc_shm_t *shm = (pc_shm_t *)mem;
+  shm->version = PC_SHM_VERSION;
+  shm->body_size = sizeof(ak_body_t);
+  shm->tether_size = sizeof(ak_tether_t);
+  shm->max_bodies = AK_MAX_BODIES;
+  shm->max_tethers = AK_MAX_TETHERS;
+  __atomic_store_n(&shm->magic, PC_SHM_MAGIC, __ATOMIC_RELEASE);
+  return shm;
+}
+
+void pc_shm_publish(pc_shm_t *shm, const ak_world_t *world, uint64_t step) {
+  // Only this process writes latest, so the next frame is never the one a
+  // reader was just sent to
+  uint32_t index = (shm->latest + 1) % PC_SHM_FRAMES;
+  pc_shm_frame_t *f = &shm->frames[index];
+
+  uint32_t seq = f->seq;
+  __atomic_store_n(&f->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+
+  f->step = step;
+  f->width = world->width;
+  f->height = world->height;
+  f->origin_x = world->origin_x;
+  f->origin_y = world->origin_y;
+  f->body_count = world->body_count;
+  f->tether_count = world->tether_count;
+  memcpy(f->bodies, world->bodies,
+         (size_t)world->body_count * sizeof(ak_body_t));
+  memcpy(f->tethers, world->tethers,
+         (size_t)world->tether_count * sizeof(ak_tether_t));
+
+  __atomic_store_n(&f->seq, seq + 2, __ATOMIC_RELEASE);
+  __atomic_store_n(&shm->latest, index, __ATOMIC_RELEASE);
+  __atomic_store_n(&shm->published, 1, __ATOMIC_RELEASE);
+}
+
+void pc_shm_destroy(pc_shm_t *shm, const char *name) {
+  char path[256];
+  SegmentName(path, sizeof(path), name);
+  munmap(shm, sizeof(pc_shm_t));
+  shm_unlink(path);
+}
+
+const pc_shm_t *pc_shm_attach(const char *name) {
+  char path[256];
+  SegmentName(path, sizeof(path), name);
+  int fd = shm_open(path, O_RDONLY, 0);
+  if (fd < 0) {
+    perror(path);
+    return NULL;
+  }
+  void *mem = mmap(NULL, sizeof(pc_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (mem == MAP_FAILED) {
+    perror(path);
+    return NULL;
+  }
+
+  const pc_shm_t *shm = (const pc_shm_t *)mem;
+  if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != PC_SHM_MAGIC ||
+      shm->version != PC_SHM_VERSION || shm->body_size != sizeof(ak_body_t) ||
+      shm->tether_size != sizeof(ak_tether_t) ||
+      shm->max_bodies != AK_MAX_BODIES || shm->max_tethers != AK_MAX_TETHERS) {
+    fprintf(stderr, "%s: not a world mirror from this build\n", path);
+    munmap(mem, sizeof(pc_shm_t));
+    return NULL;
+  }
+  return shm;
+}
+
+void pc_shm_detach(const pc_shm_t *shm) {
+  munmap((void *)shm, sizeof(pc_shm_t));
+}
+
+int pc_shm_read(const pc_shm_t *shm, pc_shm_frame_t *out) {
+  if (!__atomic_load_n(&shm->published, __ATOMIC_ACQUIRE))
+    return -1;
+
+  for (int retries = 0;; retries++) {
+    uint32_t index = __atomic_load_n(&shm->latest, __ATOMIC_ACQUIRE);
+    const pc_shm_frame_t *f = &shm->frames[index % PC_SHM_FRAMES];
+    uint32_t seq = __atomic_load_n(&f->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1)
+      continue; // The writer lapped the ring onto this frame
+
+    // Counts may be torn mid-write; clamp them before copying and let the
+    // sequence check throw the copy away
+    out->step = f->step;
+    out->width = f->width;
+    out->height = f->height;
+    out->origin_x = f->origin_x;
+    out->origin_y = f->origin_y;
+    int32_t bodies = f->body_count;
+    int32_t tethers = f->tether_count;
+    if (bodies < 0 || bodies > AK_MAX_BODIES)
+      bodies = 0;
+    if (tethers < 0 || tethers > AK_MAX_TETHERS)
+      tethers = 0;
+    memcpy(out->bodies, f->bodies, (size_t)bodies * sizeof(ak_body_t));
+    memcpy(out->tethers, f->tethers, (size_t)tethers * sizeof(ak_tether_t));
+    out->body_count = bodies;
+    out->tether_count = tethers;
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&f->seq, __ATOMIC_RELAXED) == seq) {
+      out->seq = seq;
+      return retries;
+    }
+  }
+}
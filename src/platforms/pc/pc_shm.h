@@ -0,0 +1,62 @@
+#ifndef PC_SHM_H
+#define PC_SHM_H
+
+#include "ak_physics.h"
+
+/*
+ * Live world state mirrored into POSIX shared memory, so an external viewer
+ * (src/tools/ak_shm_view.c) can watch a simulation without linking a
+ * renderer into it. After each step the publisher copies the body and tether
+ * arrays into the next frame of a small ring; each frame is guarded by a
+ * seqlock, so readers retry instead of ever blocking the writer.
+ *
+ * Bodies and tethers are stored as the raw ak_body_t / ak_tether_t arrays
+ * (one memcpy each), so the viewer must be built with the same AK_MAX_* and
+ * struct layout; pc_shm_attach checks this.
+ */
+
+#define PC_SHM_MAGIC 0x414B5348u // "AKSH"
+#define PC_SHM_VERSION 1
+#define PC_SHM_FRAMES 4
+
+typedef struct {
+  uint32_t seq; // Odd while the publisher is writing this frame
+  uint32_t pad;
+  uint64_t step;
+  ak_fixed_t width, height;
+  int32_t origin_x, origin_y;
+  int32_t body_count;
+  int32_t tether_count;
+  ak_body_t bodies[AK_MAX_BODIES];
+  ak_tether_t tethers[AK_MAX_TETHERS];
+} pc_shm_frame_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t body_size, tether_size; // Layout checks for readers
+  uint32_t max_bodies, max_tethers;
+  uint32_t latest; // Ring index of the newest complete frame
+  uint32_t published; // 0 until the first frame is out
+  pc_shm_frame_t frames[PC_SHM_FRAMES];
+} pc_shm_t;
+
+// Create (or replace) the segment /name. Returns NULL on failure.
+pc_shm_t *pc_shm_create(const char *name);
+// Mirror the world into the next frame; step is a caller-kept counter
+void pc_shm_publish(pc_shm_t *shm, const ak_world_t *world, uint64_t step);
+// Unmap and remove the segment
+void pc_shm_destroy(pc_shm_t *shm, const char *name);
+
+// Map an existing segment read-only. Returns NULL if missing or built with a
+// different layout.
+const pc_shm_t *pc_shm_attach(const char *name);
+void pc_shm_detach(const pc_shm_t *shm);
+/**
+ * Copy the newest complete frame into out (only the used part of the
+ * arrays). Returns the number of retries it took, or -1 if nothing has been
+ * published yet.
+ */
+int pc_shm_read(const pc_shm_t *shm, pc_shm_frame_t *out);
+
+#endif // PC_SHM_H
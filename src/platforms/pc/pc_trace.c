@@ -0,0 +1,404 @@
+#include "pc_trace.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIELDS 5 // id, px, py, vx, vy
+
+// --- Encoding ---
+
+static uint8_t *PutVarint(uint8_t *p, uint32_t v) {
+  while (v >= 0x80) {
+    *p++ = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  *p++ = (uint8_t)v;
+  return p;
+}
+
+// Zigzag maps small negative and positive deltas to small codes
+static uint8_t *PutDelta(uint8_t *p, int32_t value, int32_t prev) {
+  uint32_t d = (uint32_t)value - (uint32_t)prev;
+  return PutVarint(p, (d << 1) ^ (uint32_t)-(int32_t)(d >> 31));
+}
+
+// Each field is predicted from the same body's last two steps: linearly
+// extrapolated when both exist (bodies in flight move and accelerate
+// smoothly, so the residual is tiny), else the last value, else 0
+static int32_t Predict(const int32_t *last, int32_t last_n,
+                       const int32_t *older, int32_t older_n, int32_t i) {
+  if (i < last_n && i < older_n)
+    return (int32_t)(2u * (uint32_t)last[i] - (uint32_t)older[i]);
+  return i < last_n ? last[i] : 0;
+}
+
+static void Put32(uint8_t *p, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void Put64(uint8_t *p, uint64_t v) {
+  Put32(p, (uint32_t)v);
+  Put32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t Get32(const uint8_t *p) {
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 |
+         (uint32_t)p[3] << 24;
+}
+
+static uint64_t Get64(const uint8_t *p) {
+  return Get32(p) | (uint64_t)Get32(p + 4) << 32;
+}
+
+#define CHUNK_HEADER 20 // magic, step count, first step, payload bytes
+
+// Encode one buffer as a chunk and write it; runs on the writer thread
+static void WriteChunk(pc_trace_t *t, const pc_trace_buffer_t *b) {
+  // Field history of the last two steps; the older half is overwritten
+  int32_t **history = t->history;
+  int32_t history_n[2] = {0, 0}; // In fields
+  int last = 0;
+  uint8_t *p = t->out + CHUNK_HEADER;
+  const int32_t *src = b->data;
+
+  for (int s = 0; s < b->step_count; s++) {
+    uint64_t gap = s ? b->steps[s] - b->steps[s - 1] : 0;
+    p = PutVarint(p, (uint32_t)gap);
+    int32_t count = *src++;
+    p = PutVarint(p, (uint32_t)count);
+    int32_t *older = history[!last];
+    for (int32_t i = 0; i < count * FIELDS; i++) {
+      p = PutDelta(p, src[i],
+                   Predict(history[last], history_n[last], older,
+                           history_n[!last], i));
+      older[i] = src[i];
+    }
+    src += count * FIELDS;
+    last = !last;
+    history_n[last] = count * FIELDS;
+  }
+
+  uint32_t payload = (uint32_t)(p - t->out - CHUNK_HEADER);
+  Put32(t->out, PC_TRACE_CHUNK_MAGIC);
+  Put32(t->out + 4, (uint32_t)b->step_count);
+  Put64(t->out + 8, b->steps[0]);
+  Put32(t->out + 16, payload);
+  fwrite(t->out, 1, CHUNK_HEADER + payload, t->file);
+  t->stats.bytes_written += CHUNK_HEADER + payload;
+}
+
+static void *WriterThread(void *arg) {
+  pc_trace_t *t = (pc_trace_t *)arg;
+  for (;;) {
+    pthread_mutex_lock(&t->lock);
+    while (!t->pending && !t->closing)
+      pthread_cond_wait(&t->wake, &t->lock);
+    pc_trace_buffer_t *b = t->pending;
+    t->pending = NULL;
+    pthread_mutex_unlock(&t->lock);
+    if (!b)
+      break; // Closing with nothing left
+
+    WriteChunk(t, b);
+    b->step_count = 0;
+    b->used = 0;
+    __atomic_store_n(&t->writer_busy, 0, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+// --- Writer ---
+
+static size_t BufferInts(int steps_per_chunk) {
+  return (size_t)steps_per_chunk * (1 + (size_t)AK_MAX_BODIES * FIELDS);
+}
+
+static void FreeTrace(pc_trace_t *t) {
+  for (int i = 0; i < 2; i++) {
+    free(t->buffers[i].steps);
+    free(t->buffers[i].data);
+    free(t->history[i]);
+  }
+  free(t->out);
+  free(t);
+}
+
+pc_trace_t *pc_trace_open(const char *path, int steps_per_chunk) {
+  if (steps_per_chunk < 1)
+    return NULL;
+  pc_trace_t *t = (pc_trace_t *)calloc(1, sizeof(pc_trace_t));
+  if (!t)
+    return NULL;
+  t->file = fopen(path, "wb");
+  if (!t->file) {
+    perror(path);
+    free(t);
+    return NULL;
+  }
+  t->steps_per_chunk = steps_per_chunk;
+  size_t ints = BufferInts(steps_per_chunk);
+  for (int i = 0; i < 2; i++) {
+    t->buffers[i].steps =
+        (uint64_t *)malloc((size_t)steps_per_chunk * sizeof(uint64_t));
+    t->buffers[i].data = (int32_t *)malloc(ints * sizeof(int32_t));
+    t->history[i] =
+        (int32_t *)malloc((size_t)AK_MAX_BODIES * FIELDS * sizeof(int32_t));
+  }
+  // A varint takes at most 5 bytes per int32 and 10 per step gap
+  t->out = (uint8_t *)malloc(CHUNK_HEADER + ints * 5 +
+                             (size_t)steps_per_chunk * 10);
+  if (!t->buffers[0].data || !t->buffers[1].data || !t->buffers[0].steps ||
+      !t->buffers[1].steps || !t->history[0] || !t->history[1] || !t->out) {
+    fprintf(stderr, "%s: out of memory for trace buffers\n", path);
+    fclose(t->file);
+    FreeTrace(t);
+    return NULL;
+  }
+  t->fill = &t->buffers[0];
+  // Touch every page now, so page faults never land on the physics thread
+  for (int i = 0; i < 2; i++)
+    memset(t->buffers[i].data, 0, ints * sizeof(int32_t));
+
+  uint8_t header[8];
+  Put32(header, PC_TRACE_MAGIC);
+  Put32(header + 4, PC_TRACE_VERSION);
+  fwrite(header, 1, sizeof(header), t->file);
+  t->stats.bytes_written = sizeof(header);
+
+  pthread_mutex_init(&t->lock, NULL);
+  pthread_cond_init(&t->wake, NULL);
+  pthread_create(&t->thread, NULL, WriterThread, t);
+  return t;
+}
+
+// Give the fill buffer to the writer; the caller checked it is idle
+static void HandOff(pc_trace_t *t) {
+  pc_trace_buffer_t *full = t->fill;
+  t->fill = full == &t->buffers[0] ? &t->buffers[1] : &t->buffers[0];
+  __atomic_store_n(&t->writer_busy, 1, __ATOMIC_RELAXED);
+  pthread_mutex_lock(&t->lock);
+  t->pending = full;
+  pthread_cond_signal(&t->wake);
+  pthread_mutex_unlock(&t->lock);
+}
+
+static uint64_t NowNs(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void pc_trace_record(pc_trace_t *t, const ak_world_t *world, uint64_t step) {
+  uint64_t start = NowNs();
+  pc_trace_buffer_t *b = t->fill;
+
+  if (b->step_count == t->steps_per_chunk) {
+    if (__atomic_load_n(&t->writer_busy, __ATOMIC_ACQUIRE)) {
+      t->stats.dropped++; // Both halves full: never wait on the disk
+      goto done;
+    }
+    HandOff(t);
+    b = t->fill;
+  }
+
+  b->steps[b->step_count++] = step;
+  int32_t *dst = b->data + b->used;
+  *dst++ = world->body_count;
+  for (int i = 0; i < world->body_count; i++) {
+    const ak_body_t *body = &world->bodies[i];
+    *dst++ = body->id;
+    *dst++ = body->position.x;
+    *dst++ = body->position.y;
+    *dst++ = body->velocity.x;
+    *dst++ = body->velocity.y;
+  }
+  b->used = (size_t)(dst - b->data);
+  t->stats.recorded++;
+  t->stats.raw_bytes += sizeof(uint64_t) + sizeof(int32_t) +
+                        (uint64_t)world->body_count * FIELDS * sizeof(int32_t);
+
+done:;
+  uint64_t ns = NowNs() - start;
+  t->stats.record_ns += ns;
+  if (ns > t->stats.max_record_ns)
+    t->stats.max_record_ns = ns;
+}
+
+void pc_trace_close(pc_trace_t *t, pc_trace_stats_t *stats) {
+  // Wait for the writer, then flush the partial buffer
+  while (__atomic_load_n(&t->writer_busy, __ATOMIC_ACQUIRE))
+    sched_yield();
+  if (t->fill->step_count)
+    HandOff(t);
+  pthread_mutex_lock(&t->lock);
+  t->closing = 1;
+  pthread_cond_signal(&t->wake);
+  pthread_mutex_unlock(&t->lock);
+  pthread_join(t->thread, NULL);
+  pthread_mutex_destroy(&t->lock);
+  pthread_cond_destroy(&t->wake);
+
+  if (stats)
+    *stats = t->stats;
+  fclose(t->file);
+  FreeTrace(t);
+}
+
+// --- Reader ---
+
+pc_trace_reader_t *pc_trace_reader_open(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return NULL;
+  }
+  uint8_t header[CHUNK_HEADER];
+  if (fread(header, 1, 8, f) != 8 || Get32(header) != PC_TRACE_MAGIC ||
+      Get32(header + 4) != PC_TRACE_VERSION) {
+    fprintf(stderr, "%s: not a trace file\n", path);
+    fclose(f);
+    return NULL;
+  }
+
+  pc_trace_reader_t *r = (pc_trace_reader_t *)calloc(1, sizeof(*r));
+  r->file = f;
+  r->chunk = -1;
+  for (int i = 0; i < 2; i++)
+    r->state[i] =
+        (int32_t *)malloc(AK_MAX_BODIES * FIELDS * sizeof(int32_t));
+
+  // Index the chunk headers; a chunk cut short by a crash ends the trace
+  int capacity = 0;
+  while (fread(header, 1, CHUNK_HEADER, f) == CHUNK_HEADER &&
+         Get32(header) == PC_TRACE_CHUNK_MAGIC) {
+    pc_trace_chunk_t c;
+    c.step_count = Get32(header + 4);
+    c.first_step = Get64(header + 8);
+    c.payload_bytes = Get32(header + 16);
+    c.offset = ftell(f);
+    if (fseek(f, c.payload_bytes, SEEK_CUR) != 0)
+      break;
+    if (r->chunk_count == capacity) {
+      capacity = capacity ? capacity * 2 : 64;
+      r->chunks = (pc_trace_chunk_t *)realloc(r->chunks,
+                                              capacity * sizeof(*r->chunks));
+    }
+    r->chunks[r->chunk_count++] = c;
+  }
+  // The last chunk may be truncated
+  if (r->chunk_count) {
+    pc_trace_chunk_t *last = &r->chunks[r->chunk_count - 1];
+    fseek(f, 0, SEEK_END);
+    if (last->offset + (long)last->payload_bytes > ftell(f))
+      r->chunk_count--;
+  }
+  return r;
+}
+
+void pc_trace_reader_close(pc_trace_reader_t *r) {
+  fclose(r->file);
+  free(r->chunks);
+  free(r->payload);
+  free(r->state[0]);
+  free(r->state[1]);
+  free(r);
+}
+
+static int GetVarint(pc_trace_reader_t *r, uint32_t *v) {
+  const pc_trace_chunk_t *c = &r->chunks[r->chunk];
+  uint32_t result = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (r->pos >= c->payload_bytes)
+      return 0;
+    uint8_t byte = r->payload[r->pos++];
+    result |= (uint32_t)(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      *v = result;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int LoadChunk(pc_trace_reader_t *r, int index) {
+  const pc_trace_chunk_t *c = &r->chunks[index];
+  uint8_t *p = (uint8_t *)realloc(r->payload, c->payload_bytes + 1);
+  if (!p)
+    return 0;
+  r->payload = p;
+  if (fseek(r->file, c->offset, SEEK_SET) != 0 ||
+      fread(r->payload, 1, c->payload_bytes, r->file) != c->payload_bytes)
+    return 0;
+  r->chunk = index;
+  r->pos = 0;
+  r->steps_done = 0;
+  r->step = c->first_step;
+  r->state_n[0] = r->state_n[1] = 0;
+  return 1;
+}
+
+// Decode the next step of the loaded chunk into the cursor state
+static int DecodeStep(pc_trace_reader_t *r) {
+  uint32_t gap, count;
+  if (!GetVarint(r, &gap) || !GetVarint(r, &count) || count > AK_MAX_BODIES)
+    return 0;
+  if (r->steps_done)
+    r->step += gap;
+  int last = r->last;
+  int32_t *older = r->state[!last];
+  for (int32_t i = 0; i < (int32_t)count * FIELDS; i++) {
+    uint32_t z;
+    if (!GetVarint(r, &z))
+      return 0;
+    uint32_t d = (z >> 1) ^ (uint32_t)-(int32_t)(z & 1);
+    older[i] = (int32_t)((uint32_t)Predict(r->state[last], r->state_n[last],
+                                           older, r->state_n[!last], i) +
+                         d);
+  }
+  r->last = !last;
+  r->state_n[r->last] = (int32_t)count * FIELDS;
+  r->steps_done++;
+  return 1;
+}
+
+int pc_trace_read_step(pc_trace_reader_t *r, uint64_t step,
+                       pc_trace_body_t *bodies, int max_bodies) {
+  // Last chunk starting at or before the step
+  int lo = 0, hi = r->chunk_count - 1, index = -1;
+  while (lo <= hi) {
+    int mid = (lo + hi) / 2;
+    if (r->chunks[mid].first_step <= step) {
+      index = mid;
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  if (index < 0)
+    return -1;
+
+  // Continue from the cursor when possible, else restart the chunk
+  if (r->chunk != index || !r->steps_done || r->step > step) {
+    if (!LoadChunk(r, index))
+      return -1;
+  }
+  const pc_trace_chunk_t *c = &r->chunks[index];
+  while (!r->steps_done || r->step < step) {
+    if (r->steps_done == c->step_count || !DecodeStep(r))
+      return -1;
+  }
+  if (r->step != step)
+    return -1; // In a gap left by dropped steps
+
+  int32_t body_count = r->state_n[r->last] / FIELDS;
+  int n = body_count < max_bodies ? body_count : max_bodies;
+  for (int i = 0; i < n; i++) {
+    const int32_t *f = r->state[r->last] + i * FIELDS;
+    bodies[i].id = f[0];
+    bodies[i].position = (ak_vec2_t){f[1], f[2]};
+    bodies[i].velocity = (ak_vec2_t){f[3], f[4]};
+  }
+  return body_count;
+}
@@ -0,0 +1,105 @@
+#ifndef PC_TRACE_H
+#define PC_TRACE_H
+
+#include "ak_physics.h"
+#include <pthread.h>
+#include <stdio.h>
+
+/*
+ * Per-step body traces for long runs. The physics thread only copies each
+ * body's id, position and velocity into the fill half of a double buffer;
+ * a background thread encodes every step as zigzag varint residuals against
+ * a prediction from the two steps before it (so bodies at rest or in smooth
+ * flight cost a few bytes) and streams the result to disk. If the writer
+ * falls behind, steps are dropped and counted rather than stalling the step.
+ *
+ * The file is a header followed by chunks of up to steps_per_chunk steps.
+ * Each chunk starts from zero state, so the reader can seek to any step by
+ * decoding at most one chunk.
+ */
+
+#define PC_TRACE_MAGIC 0x52544B41u       // "AKTR"
+#define PC_TRACE_CHUNK_MAGIC 0x43544B41u // "AKTC"
+#define PC_TRACE_VERSION 1
+
+typedef struct {
+  int32_t id;
+  ak_vec2_t position;
+  ak_vec2_t velocity;
+} pc_trace_body_t;
+
+typedef struct {
+  uint64_t recorded;      // Steps handed to the writer
+  uint64_t dropped;       // Steps lost because the writer was behind
+  uint64_t bytes_written; // Compressed bytes on disk
+  uint64_t raw_bytes;     // What the recorded steps take uncompressed
+  uint64_t record_ns;     // Physics-thread time spent in pc_trace_record
+  uint64_t max_record_ns; // Longest single call
+} pc_trace_stats_t;
+
+// Raw steps waiting to be encoded
+typedef struct {
+  uint64_t *steps; // Step number of each snapshot
+  int32_t *data;   // Per snapshot: count, then count * (id, px, py, vx, vy)
+  int step_count;
+  size_t used; // In int32s
+} pc_trace_buffer_t;
+
+typedef struct {
+  FILE *file;
+  int steps_per_chunk;
+  pc_trace_buffer_t buffers[2];
+  pc_trace_buffer_t *fill;    // Physics thread only
+  pc_trace_buffer_t *pending; // Handed to the writer, NULL once taken
+  int writer_busy;            // Set by the physics thread, cleared by writer
+  int closing;
+  uint8_t *out; // Writer-side encode buffer
+  int32_t *history[2]; // Writer-side fields of the last two encoded steps
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pc_trace_stats_t stats;
+} pc_trace_t;
+
+// Returns NULL if the file cannot be created
+pc_trace_t *pc_trace_open(const char *path, int steps_per_chunk);
+// Physics thread, after each step
+void pc_trace_record(pc_trace_t *trace, const ak_world_t *world,
+                     uint64_t step);
+// Flush, stop the writer and close the file. Fills *stats if non-NULL.
+void pc_trace_close(pc_trace_t *trace, pc_trace_stats_t *stats);
+
+// Reader: an index of chunk offsets, plus the chunk being decoded
+typedef struct {
+  uint64_t first_step;
+  long offset; // Of the payload
+  uint32_t step_count, payload_bytes;
+} pc_trace_chunk_t;
+
+typedef struct {
+  FILE *file;
+  pc_trace_chunk_t *chunks;
+  int chunk_count;
+  // Decoding cursor
+  int chunk;      // Loaded chunk, -1 if none
+  uint8_t *payload;
+  size_t pos;
+  uint32_t steps_done; // Steps of the chunk decoded so far
+  uint64_t step;       // Last decoded step
+  int32_t *state[2];   // Fields of the last two decoded steps
+  int32_t state_n[2];  // In fields
+  int last;            // Which state is the last decoded step
+} pc_trace_reader_t;
+
+// Returns NULL if the file is missing or not a trace
+pc_trace_reader_t *pc_trace_reader_open(const char *path);
+void pc_trace_reader_close(pc_trace_reader_t *reader);
+/**
+ * Decode the given step into bodies (up to max_bodies). Returns the body
+ * count, or -1 if the step is not in the trace (never recorded, or dropped).
+ * Reading steps in increasing order only decodes each step once.
+ */
+int pc_trace_read_step(pc_trace_reader_t *reader, uint64_t step,
+                       pc_trace_body_t *bodies, int max_bodies);
+
+#endif // PC_TRACE_H
@@ -1,8 +1,10 @@
 #include "ak_demo_setup.h"
+#include "ak_draw.h"
 #include "ak_physics.h"
 #include "pd_api.h"
 
 static ak_world_t world;
+static ak_draw_list_t draw_list;
 static PlaydateAPI *pd = NULL;
 
 static int update(void *userdata) {
@@ -20,36 +22,27 @@ static int update(void *userdata) {
     ak_demo_create_standard_scene(&world);
   }
 
-  for (int i = 0; i < world.body_count; i++) {
-    ak_body_t *b = &world.bodies[i];
-    int x = AK_FIXED_TO_INT(b->position.x);
-    int y = AK_FIXED_TO_INT(b->position.y);
+  ak_world_build_draw_list(&world, (ak_draw_viewport_t){{0, 0}, 400, 240},
+                           (ak_vec2_t){AK_FIXED_ONE, AK_FIXED_ONE},
+                           &draw_list);
+  const ak_draw_prim_t *p = draw_list.prims;
 
-    if (b->shape.type == AK_SHAPE_CIRCLE) {
-      int r = AK_FIXED_TO_INT(b->shape.bounds.circle.radius);
-      pd->graphics->drawEllipse(x - r, y - r, r * 2, r * 2, 1, 0, 360,
-                                kColorBlack);
-    } else if (b->shape.type == AK_SHAPE_AABB) {
-      int w = AK_FIXED_TO_INT(b->shape.bounds.aabb.width);
-      int h = AK_FIXED_TO_INT(b->shape.bounds.aabb.height);
-      pd->graphics->drawRect(x - w, y - h, w * 2, h * 2, kColorBlack);
-    }
+  for (int i = 0; i < draw_list.circle_count; i++, p++) {
+    const ak_draw_circle_t *c = &p->circle;
+    pd->graphics->drawEllipse(c->x - c->r, c->y - c->r, c->r * 2, c->r * 2, 1,
+                              0, 360, kColorBlack);
   }
 
-  // Draw Tethers
-  for (int i = 0; i < world.tether_count; i++) {
-    ak_tether_t *t = &world.tethers[i];
-    if (t->a == NULL || t->b == NULL)
-      continue;
-
-    int x1 = AK_FIXED_TO_INT(t->a->position.x);
-    int y1 = AK_FIXED_TO_INT(t->a->position.y);
-    int x2 = AK_FIXED_TO_INT(t->b->position.x);
-    int y2 = AK_FIXED_TO_INT(t->b->position.y);
-
-    pd->graphics->drawLine(x1, y1, x2, y2, 1, kColorBlack);
+  for (int i = 0; i < draw_list.rect_count; i++, p++) {
+    pd->graphics->drawRect(p->rect.x, p->rect.y, p->rect.w, p->rect.h,
+                           kColorBlack);
+  }
 
-    // TODO: Draw curve when tether is slack (current_dist < length)
+  // Tethers and rope segments
+  // TODO: Draw curve when tether is slack (current_dist < length)
+  for (int i = 0; i < draw_list.line_count; i++, p++) {
+    pd->graphics->drawLine(p->line.x1, p->line.y1, p->line.x2, p->line.y2, 1,
+                           kColorBlack);
   }
 
   return 1;
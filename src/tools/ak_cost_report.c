@@ -0,0 +1,215 @@
+// Estimated per-console cost of a scene, from counted fixed-point operations.
+//
+//   ak_cost_report [-s steps] [-p particles] [scene.aks]
+//
+// Built with -DAK_COUNT_OPS (see `make tools`). Runs the scene (the standard
+// demo scene at 320x240 if no file is given) and reports the multiplies,
+// divides and square roots per step by phase and by call site, then turns
+// them into cycles per step and a share of the frame budget for each target.
+//
+// On these CPUs the step is dominated by the multiply/divide helpers and the
+// square-root loop, so the estimate counts only those; the
+// rest of the step (loads, compares, branches) comes on top.
+#include "ak_demo_setup.h"
+#include "ak_ops.h"
+#include "ak_particles.h"
+#include "ak_scene.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef AK_COUNT_OPS
+#error "ak_cost_report must be built with -DAK_COUNT_OPS"
+#endif
+
+typedef struct {
+  const char *name;
+  double cpu_mhz;
+  int fps;
+  int steps_per_frame;    // Fixed 1/60 s steps run per displayed frame
+  int cycles[AK_OP_COUNT]; // MUL, DIV, SQRT
+} ak_cost_target_t;
+
+// Cycles per operation, from instruction timings of the code each compiler
+// emits for the 16.16 macros with the backend the target builds with
+// (AK_MATH_32 on Jaguar, Lynx and Arduboy, 64-bit helpers on Playdate) and
+// the 32-iteration square-root loop. Rough figures: calibrate them here when
+// hardware measurements are available.
+static const ak_cost_target_t targets[] = {
+    // 68000: three MULS.W and a MULU.W (~70 cycles each) plus shifts and
+    // adds; __udivsi3 for the integer part and 16 shift-subtract steps for
+    // the fraction. The root loop runs 64-bit steps in register pairs.
+    {"Jaguar (68000)", 13.295, 60, 1, {300, 1300, 2600}},
+    // 65C02: no multiply instruction; four 16x16 shift-add multiplies and
+    // 4-byte shift-subtract loops.
+    {"Lynx (65C02)", 4.0, 60, 1, {2600, 3800, 6400}},
+    // AVR: 8x8 MUL builds each 16x16 product; division and roots are bit
+    // loops.
+    {"Arduboy (AVR)", 16.0, 60, 1, {110, 900, 1600}},
+    // Cortex-M7: SMULL, __aeabi_ldivmod, cheap 64-bit shifts. 30 fps with
+    // two steps per frame, as playdate_demo.c runs it.
+    {"Playdate (M7)", 168.0, 30, 2, {3, 90, 260}},
+};
+
+static const char *phase_names[AK_PHASE_COUNT] = {
+    "other",   "integrate", "pairs", "statics",
+    "tilemap", "tethers",   "ropes", "particles"};
+
+static ak_world_t world;
+static ak_particles_t particles;
+
+static void *ReadFile(const char *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    perror(path);
+    return NULL;
+  }
+  fseek(f, 0, SEEK_END);
+  long len = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  void *data = len > 0 ? malloc((size_t)len) : NULL;
+  if (!data || fread(data, 1, (size_t)len, f) != (size_t)len) {
+    fprintf(stderr, "%s: cannot read\n", path);
+    free(data);
+    fclose(f);
+    return NULL;
+  }
+  fclose(f);
+  *size = (size_t)len;
+  return data;
+}
+
+static int CompareSites(const void *a, const void *b) {
+  const ak_ops_site_t *x = (const ak_ops_site_t *)a;
+  const ak_ops_site_t *y = (const ak_ops_site_t *)b;
+  uint64_t tx = x->count[AK_OP_MUL] + x->count[AK_OP_DIV] * 8 +
+                x->count[AK_OP_SQRT] * 8;
+  uint64_t ty = y->count[AK_OP_MUL] + y->count[AK_OP_DIV] * 8 +
+                y->count[AK_OP_SQRT] * 8;
+  return tx < ty ? 1 : tx > ty ? -1 : 0;
+}
+
+static void Usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-s steps] [-p particles] [scene.aks]\n", prog);
+}
+
+int main(int argc, char **argv) {
+  long steps = 600, particle_count = 0;
+  const char *scene_path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-') {
+      scene_path = argv[i];
+      continue;
+    }
+    if (i + 1 >= argc || strlen(argv[i]) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 's': steps = atol(v); break;
+    case 'p': particle_count = atol(v); break;
+    default: Usage(argv[0]); return 2;
+    }
+  }
+  if (steps < 1 || particle_count < 0) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  if (scene_path) {
+    size_t size;
+    void *data = ReadFile(scene_path, &size);
+    if (!data)
+      return 1;
+    ak_scene_result_t r = ak_scene_load(&world, data, size);
+    free(data);
+    if (r != AK_SCENE_OK) {
+      fprintf(stderr, "%s: cannot load scene (error %d)\n", scene_path, r);
+      return 1;
+    }
+  } else {
+    world.width = AK_INT_TO_FIXED(320);
+    world.height = AK_INT_TO_FIXED(240);
+    ak_demo_create_standard_scene(&world);
+  }
+
+  // Particles rain down evenly across the world and never expire
+  ak_particles_init(&particles, AK_INT_TO_FIXED(1) / 2);
+  for (long i = 0; i < particle_count; i++) {
+    ak_vec2_t pos = {(ak_fixed_t)((int64_t)world.width * (i % 97) / 97),
+                     -AK_INT_TO_FIXED((int)(i / 97))};
+    if (ak_particles_emit(&particles, pos, (ak_vec2_t){0, 0}, 0) < 0)
+      break;
+  }
+
+  ak_fixed_t dt = AK_INT_TO_FIXED(1) / 60;
+  ak_ops_reset();
+  for (long s = 0; s < steps; s++) {
+    ak_world_step(&world, dt);
+    if (particles.count)
+      ak_particles_step(&particles, &world, dt);
+  }
+
+  printf("%s: %d bodies, %d tethers, %d ropes, %d particles, %ld steps\n\n",
+         scene_path ? scene_path : "standard scene", world.body_count,
+         world.tether_count, world.rope_count, particles.count, steps);
+
+  // Operations per step
+  double per_step[AK_OP_COUNT] = {0};
+  printf("%-12s %12s %12s %12s\n", "per step", "mul", "div", "sqrt");
+  for (int p = 0; p < AK_PHASE_COUNT; p++) {
+    const uint64_t *c = ak_ops.by_phase[p];
+    if (!c[AK_OP_MUL] && !c[AK_OP_DIV] && !c[AK_OP_SQRT])
+      continue;
+    printf("%-12s", phase_names[p]);
+    for (int op = 0; op < AK_OP_COUNT; op++) {
+      double v = (double)c[op] / (double)steps;
+      per_step[op] += v;
+      printf(" %12.1f", v);
+    }
+    printf("\n");
+  }
+  printf("%-12s %12.1f %12.1f %12.1f\n\n", "total", per_step[AK_OP_MUL],
+         per_step[AK_OP_DIV], per_step[AK_OP_SQRT]);
+
+  // Hottest call sites
+  static ak_ops_site_t sites[AK_OPS_MAX_SITES];
+  int site_count = 0;
+  for (int i = 0; i < AK_OPS_MAX_SITES; i++) {
+    if (ak_ops.sites[i].file)
+      sites[site_count++] = ak_ops.sites[i];
+  }
+  qsort(sites, (size_t)site_count, sizeof(sites[0]), CompareSites);
+  printf("%-34s %10s %10s %10s\n", "hottest call sites", "mul", "div",
+         "sqrt");
+  for (int i = 0; i < site_count && i < 12; i++) {
+    char where[64];
+    const char *base = strrchr(sites[i].file, '/');
+    snprintf(where, sizeof(where), "%s:%d", base ? base + 1 : sites[i].file,
+             sites[i].line);
+    printf("%-34s %10.1f %10.1f %10.1f\n", where,
+           (double)sites[i].count[AK_OP_MUL] / (double)steps,
+           (double)sites[i].count[AK_OP_DIV] / (double)steps,
+           (double)sites[i].count[AK_OP_SQRT] / (double)steps);
+  }
+  if (ak_ops.lost)
+    printf("(%llu tallies from sites beyond AK_OPS_MAX_SITES not listed)\n",
+           (unsigned long long)ak_ops.lost);
+  printf("\n");
+
+  // Per-target estimate
+  printf("%-16s %8s %12s %12s %8s\n", "target", "fps", "cycles/step",
+         "frame budget", "used");
+  for (size_t t = 0; t < sizeof(targets) / sizeof(targets[0]); t++) {
+    const ak_cost_target_t *tg = &targets[t];
+    double cycles = 0;
+    for (int op = 0; op < AK_OP_COUNT; op++)
+      cycles += per_step[op] * tg->cycles[op];
+    double budget = tg->cpu_mhz * 1e6 / tg->fps;
+    printf("%-16s %8d %12.0f %12.0f %7.1f%%\n", tg->name, tg->fps, cycles,
+           budget, 100.0 * cycles * tg->steps_per_frame / budget);
+  }
+  return 0;
+}
@@ -0,0 +1,443 @@
+// Determinism regression harness.
+//
+//   ak_determinism [-g golden_dir] [-w] [-s steps] [-c interval] [scene...]
+//
+// Runs a fixed library of scenes through ak_world_step and hashes the state
+// of every body (and rope node) at checkpoints. By default the hashes are
+// compared with the golden files in golden_dir (one <scene>.txt per scene);
+// -w writes them instead. `make determinism` builds this tool under every
+// host configuration (optimization levels, LTO, -march=native, the solver
+// compiled as C++, AK_MATH_32, -m32 where available) and checks each build
+// against the same golden files, so any of them drifting from the reference
+// results is caught.
+//
+// Scenes that ak_world_pack_load accepts are also run as a world pack, one
+// differently pushed copy of the scene per lane, and every lane is checked
+// against the same copy stepped alone with ak_world_step.
+//
+// A divergence is reported as the checkpoint where it was first seen (it
+// happened after the previous one) and the first body whose hash differs
+// there. To pin down the exact step, write golden files with -c 1 from a
+// good build into a scratch directory and compare the bad build against
+// them.
+#include "ak_demo_setup.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef AK_DET_CONFIG
+#define AK_DET_CONFIG "default"
+#endif
+
+static ak_world_t world;
+static ak_static_world_t statics;
+static uint32_t rng_state;
+
+static uint32_t NextRandom(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+// --- Scenes ---
+
+static void Standard(ak_world_t *w, int width, int height) {
+  w->width = AK_INT_TO_FIXED(width);
+  w->height = AK_INT_TO_FIXED(height);
+  ak_demo_create_standard_scene(w);
+}
+
+// Each console's screen size scales the standard scene differently
+static void StandardPC(ak_world_t *w) { Standard(w, 320, 240); }
+static void StandardLynx(ak_world_t *w) { Standard(w, 160, 102); }
+static void StandardArduboy(ak_world_t *w) { Standard(w, 128, 64); }
+static void StandardPlaydate(ak_world_t *w) { Standard(w, 400, 240); }
+
+static ak_shape_t RandomShape(ak_fixed_t min, uint32_t range) {
+  ak_shape_t s;
+  ak_fixed_t extent = min + (ak_fixed_t)(NextRandom() % range);
+  if (NextRandom() & 1) {
+    s.type = AK_SHAPE_CIRCLE;
+    s.bounds.circle.radius = extent;
+  } else {
+    s.type = AK_SHAPE_AABB;
+    s.bounds.aabb.width = extent;
+    s.bounds.aabb.height = extent + (ak_fixed_t)(NextRandom() % 0x20000);
+  }
+  return s;
+}
+
+// A jittered grid of mixed bodies with some tethered pairs, dropped onto a
+// floor and a row of pegs
+static void Pile(ak_world_t *w) {
+  ak_world_init(w, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
+                (ak_vec2_t){0, AK_INT_TO_FIXED(50)});
+  rng_state = 12345;
+
+  ak_shape_t floor = {AK_SHAPE_AABB, {{0}}};
+  floor.bounds.aabb.width = AK_INT_TO_FIXED(160);
+  floor.bounds.aabb.height = AK_INT_TO_FIXED(10);
+  ak_world_add_body(w, floor, AK_INT_TO_FIXED(160), AK_INT_TO_FIXED(235), 0);
+  ak_shape_t peg = {AK_SHAPE_CIRCLE, {{0}}};
+  peg.bounds.circle.radius = AK_INT_TO_FIXED(5);
+  for (int x = 40; x < 320; x += 60)
+    ak_world_add_body(w, peg, AK_INT_TO_FIXED(x), AK_INT_TO_FIXED(150), 0);
+
+  int first = w->body_count;
+  for (int i = 0; i < 40; i++) {
+    ak_body_t *b = ak_world_add_body(
+        w, RandomShape(AK_INT_TO_FIXED(3), 0x50000),
+        AK_INT_TO_FIXED(40 + (i % 10) * 24) + (ak_fixed_t)(NextRandom() % 0x40000),
+        AK_INT_TO_FIXED(20 + (i / 10) * 24),
+        AK_INT_TO_FIXED(1) + (ak_fixed_t)(NextRandom() % 0x30000));
+    b->id = i + 1;
+    b->velocity.x = (ak_fixed_t)(NextRandom() % 0x280000) - 0x140000;
+  }
+  for (int i = first; i + 1 < w->body_count && w->tether_count < 8; i += 5)
+    ak_world_add_tether(w, &w->bodies[i], &w->bodies[i + 1],
+                        AK_INT_TO_FIXED(30));
+}
+
+// Terraced level with a pit, 16px tiles
+#define TILES_W 20
+#define TILES_H 15
+static uint8_t level[TILES_W * TILES_H];
+
+static void Tilemap(ak_world_t *w) {
+  ak_world_init(w, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
+                (ak_vec2_t){0, AK_INT_TO_FIXED(50)});
+  rng_state = 777;
+
+  for (int y = 0; y < TILES_H; y++) {
+    for (int x = 0; x < TILES_W; x++) {
+      int ground = TILES_H - 2 - (x < 6 ? 3 : x < 12 ? 0 : 2);
+      level[y * TILES_W + x] =
+          y == TILES_H - 1 || x == 0 || x == TILES_W - 1 ||
+          (y >= ground && !(x >= 8 && x <= 9));
+    }
+  }
+  ak_world_set_tilemap(w, level, TILES_W, TILES_H, AK_INT_TO_FIXED(16),
+                       (ak_vec2_t){0, 0});
+
+  for (int i = 0; i < 24; i++) {
+    ak_body_t *b = ak_world_add_body(
+        w, RandomShape(AK_INT_TO_FIXED(3), 0x40000),
+        AK_INT_TO_FIXED(30 + (i % 12) * 22), AK_INT_TO_FIXED(20 + (i / 12) * 20),
+        AK_INT_TO_FIXED(2));
+    b->id = i + 1;
+    b->velocity.x = (ak_fixed_t)(NextRandom() % 0x3C0000) - 0x1E0000;
+  }
+}
+
+// Bodies bouncing through a grid of shared static pegs
+static void Statics(ak_world_t *w) {
+  ak_world_init(w, AK_INT_TO_FIXED(320), AK_INT_TO_FIXED(240),
+                (ak_vec2_t){0, AK_INT_TO_FIXED(50)});
+  rng_state = 4242;
+
+  ak_static_world_init(&statics);
+  ak_shape_t peg = {AK_SHAPE_CIRCLE, {{0}}};
+  peg.bounds.circle.radius = AK_INT_TO_FIXED(4);
+  for (int row = 0; row < 5; row++) {
+    for (int x = 20 + (row & 1) * 15; x < 310; x += 30)
+      ak_static_world_add_body(&statics, peg, AK_INT_TO_FIXED(x),
+                               AK_INT_TO_FIXED(80 + row * 25));
+  }
+  ak_shape_t floor = {AK_SHAPE_AABB, {{0}}};
+  floor.bounds.aabb.width = AK_INT_TO_FIXED(160);
+  floor.bounds.aabb.height = AK_INT_TO_FIXED(8);
+  ak_static_world_add_body(&statics, floor, AK_INT_TO_FIXED(160),
+                           AK_INT_TO_FIXED(236));
+  ak_static_world_build(&statics, AK_INT_TO_FIXED(32));
+  ak_world_set_static(w, &statics);
+
+  for (int i = 0; i < 30; i++) {
+    ak_body_t *b = ak_world_add_body(
+        w, RandomShape(AK_INT_TO_FIXED(2), 0x30000),
+        AK_INT_TO_FIXED(15 + (i % 15) * 20) + (ak_fixed_t)(NextRandom() % 0x60000),
+        AK_INT_TO_FIXED(10 + (i / 15) * 20), AK_INT_TO_FIXED(1));
+    b->id = i + 1;
+  }
+}
+
+typedef struct {
+  const char *name;
+  void (*build)(ak_world_t *w);
+} scene_t;
+
+static const scene_t scenes[] = {
+    {"standard_pc", StandardPC},
+    {"standard_lynx", StandardLynx},
+    {"standard_arduboy", StandardArduboy},
+    {"standard_playdate", StandardPlaydate},
+    {"pile", Pile},
+    {"tilemap", Tilemap},
+    {"statics", Statics},
+};
+#define SCENE_COUNT ((int)(sizeof(scenes) / sizeof(scenes[0])))
+
+// --- Hashing ---
+
+static uint32_t Mix(uint32_t h, int32_t v) {
+  // FNV-1a over the little-endian bytes, whatever the host order
+  uint32_t u = (uint32_t)v;
+  for (int i = 0; i < 4; i++) {
+    h = (h ^ (u & 0xFF)) * 16777619u;
+    u >>= 8;
+  }
+  return h;
+}
+
+static uint32_t BodyHash(const ak_body_t *b) {
+  uint32_t h = 2166136261u;
+  h = Mix(h, b->id);
+  h = Mix(h, b->position.x);
+  h = Mix(h, b->position.y);
+  h = Mix(h, b->velocity.x);
+  return Mix(h, b->velocity.y);
+}
+
+// Per-body hashes are folded to 16 bits to keep the golden files small; the
+// world hash uses all 32
+static unsigned Short(uint32_t h) { return (h ^ (h >> 16)) & 0xFFFF; }
+
+static uint32_t WorldHash(const ak_world_t *w, unsigned *body_hashes) {
+  uint32_t h = Mix(2166136261u, w->body_count);
+  for (int i = 0; i < w->body_count; i++) {
+    uint32_t bh = BodyHash(&w->bodies[i]);
+    body_hashes[i] = Short(bh);
+    h = Mix(h, (int32_t)bh);
+  }
+  for (int i = 0; i < w->rope_node_count; i++) {
+    const ak_rope_node_t *n = &w->rope_nodes[i];
+    h = Mix(Mix(h, n->position.x), n->position.y);
+    h = Mix(Mix(h, n->velocity.x), n->velocity.y);
+  }
+  return h;
+}
+
+// --- Golden files ---
+
+typedef struct {
+  long step;
+  uint32_t hash;
+  int body_count;
+  unsigned bodies[AK_MAX_BODIES];
+} checkpoint_t;
+
+static int ReadCheckpoint(FILE *f, checkpoint_t *c) {
+  unsigned long hash;
+  if (fscanf(f, "%ld %lx %d", &c->step, &hash, &c->body_count) != 3 ||
+      c->body_count < 0 || c->body_count > AK_MAX_BODIES)
+    return 0;
+  c->hash = (uint32_t)hash;
+  for (int i = 0; i < c->body_count; i++) {
+    if (fscanf(f, "%x", &c->bodies[i]) != 1)
+      return 0;
+  }
+  return 1;
+}
+
+static void WriteCheckpoint(FILE *f, const checkpoint_t *c) {
+  fprintf(f, "%ld %08lx %d", c->step, (unsigned long)c->hash, c->body_count);
+  for (int i = 0; i < c->body_count; i++)
+    fprintf(f, " %04x", c->bodies[i]);
+  fprintf(f, "\n");
+}
+
+// Returns 1 if the scene matched (or was written)
+static int RunScene(const scene_t *scene, const char *dir, int write,
+                    long steps, long interval) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s.txt", dir, scene->name);
+  FILE *f = fopen(path, write ? "w" : "r");
+  if (!f) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return 0;
+  }
+
+  if (write) {
+    fprintf(f, "# ak_determinism %s: step hash body_count body_hashes...\n",
+            scene->name);
+    fprintf(f, "steps %ld interval %ld\n", steps, interval);
+  } else {
+    char line[256];
+    if (!fgets(line, sizeof(line), f) ||
+        fscanf(f, " steps %ld interval %ld", &steps, &interval) != 2 ||
+        steps < 1 || interval < 1) {
+      fprintf(stderr, "%s: not a golden file\n", path);
+      fclose(f);
+      return 0;
+    }
+  }
+
+  scene->build(&world);
+  ak_fixed_t dt = AK_INT_TO_FIXED(1) / 60;
+  checkpoint_t got, want;
+  long last_good = 0;
+  int ok = 1;
+  for (long step = 1; step <= steps; step++) {
+    ak_world_step(&world, dt);
+    if (step % interval != 0 && step != steps)
+      continue;
+
+    got.step = step;
+    got.body_count = world.body_count;
+    got.hash = WorldHash(&world, got.bodies);
+    if (write) {
+      WriteCheckpoint(f, &got);
+      continue;
+    }
+
+    if (!ReadCheckpoint(f, &want) || want.step != step) {
+      printf("%-18s golden file ends or is misaligned at step %ld\n",
+             scene->name, step);
+      ok = 0;
+      break;
+    }
+    if (want.hash == got.hash) {
+      last_good = step;
+      continue;
+    }
+
+    // First divergence: name the first body that differs
+    printf("%-18s DIVERGED after step %ld, first seen at step %ld: ",
+           scene->name, last_good, step);
+    if (want.body_count != got.body_count) {
+      printf("body count %d, expected %d\n", got.body_count, want.body_count);
+    } else {
+      int i = 0;
+      while (i < got.body_count && got.bodies[i] == want.bodies[i])
+        i++;
+      if (i < got.body_count) {
+        const ak_body_t *b = &world.bodies[i];
+        printf("body %d (id %d) hash %04x, expected %04x; now at %.4f, %.4f\n",
+               i, b->id, got.bodies[i], want.bodies[i],
+               AK_FIXED_TO_FLOAT(b->position.x),
+               AK_FIXED_TO_FLOAT(b->position.y));
+      } else {
+        printf("rope nodes\n");
+      }
+    }
+    ok = 0;
+    break;
+  }
+  if (ok && !write)
+    printf("%-18s ok (%ld steps)\n", scene->name, steps);
+  fclose(f);
+  return ok;
+}
+
+// --- World packs ---
+
+static ak_world_t lanes[AK_PACK_LANES];
+static ak_world_t packed; // A lane stored back out of the pack
+static ak_world_pack_t pack;
+
+// Returns 1 if every lane matched its world, 0 if not, -1 if the pack
+// cannot step the scene
+static int RunPack(const scene_t *scene, long steps, long interval) {
+  const ak_world_t *worlds[AK_PACK_LANES];
+  for (int l = 0; l < AK_PACK_LANES; l++) {
+    scene->build(&lanes[l]);
+    for (int i = 0; i < lanes[l].body_count; i++) {
+      ak_body_t *b = &lanes[l].bodies[i];
+      if (!b->is_static)
+        b->velocity.x += (i & 1 ? 0x8000 : -0x8000) * (ak_fixed_t)l;
+    }
+    worlds[l] = &lanes[l];
+  }
+  if (!ak_world_pack_load(&pack, worlds, AK_PACK_LANES))
+    return -1;
+  packed = lanes[0];
+
+  ak_fixed_t dt = AK_INT_TO_FIXED(1) / 60;
+  unsigned want[AK_MAX_BODIES], got[AK_MAX_BODIES];
+  for (long step = 1; step <= steps; step++) {
+    ak_world_pack_step(&pack, dt);
+    for (int l = 0; l < AK_PACK_LANES; l++)
+      ak_world_step(&lanes[l], dt);
+    if (step % interval != 0 && step != steps)
+      continue;
+    for (int l = 0; l < AK_PACK_LANES; l++) {
+      ak_world_pack_store(&pack, l, &packed);
+      if (WorldHash(&packed, got) == WorldHash(&lanes[l], want))
+        continue;
+      int i = 0;
+      while (i < packed.body_count && got[i] == want[i])
+        i++;
+      printf("%-18s PACK lane %d differs at step %ld: body %d (id %d)\n",
+             scene->name, l, step, i, lanes[l].bodies[i].id);
+      return 0;
+    }
+  }
+  printf("%-18s pack ok (%d lanes, %ld steps)\n", scene->name, AK_PACK_LANES,
+         steps);
+  return 1;
+}
+
+static void Usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [-g golden_dir] [-w] [-s steps] [-c interval] "
+          "[scene...]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  const char *dir = "src/tools/golden";
+  int write = 0;
+  long steps = 2000, interval = 20;
+  const char *only[SCENE_COUNT];
+  int only_count = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-') {
+      if (only_count < SCENE_COUNT)
+        only[only_count++] = argv[i];
+      continue;
+    }
+    if (strcmp(argv[i], "-w") == 0) {
+      write = 1;
+      continue;
+    }
+    if (i + 1 >= argc || strlen(argv[i]) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 'g': dir = v; break;
+    case 's': steps = atol(v); break;
+    case 'c': interval = atol(v); break;
+    default: Usage(argv[0]); return 2;
+    }
+  }
+  if (steps < 1 || interval < 1) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  printf("ak_determinism [%s]\n", AK_DET_CONFIG);
+  int failed = 0, ran = 0;
+  for (int s = 0; s < SCENE_COUNT; s++) {
+    int wanted = only_count == 0;
+    for (int k = 0; k < only_count; k++)
+      wanted |= strcmp(only[k], scenes[s].name) == 0;
+    if (!wanted)
+      continue;
+    ran++;
+    if (!RunScene(&scenes[s], dir, write, steps, interval))
+      failed++;
+    if (!write && RunPack(&scenes[s], steps, interval) == 0)
+      failed++;
+  }
+  if (ran == 0) {
+    fprintf(stderr, "no such scene\n");
+    return 2;
+  }
+  if (write)
+    printf("wrote %d golden files to %s\n", ran - failed, dir);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+// Checks the C++ wrappers (src/core/ak_fixed.hpp) against the C macros and
+// ak_vec2_* functions they mirror. Built as C++14, once per math backend
+// (ak_fixed_check, and ak_fixed_check_32 with -DAK_MATH_32), with the C
+// sources compiled as C++ in the same build, as the Lynx front-end does.
+//
+//   ak_fixed_check [-n random_pairs]
+//
+// Every ak::fixed operator, conversion and helper, and every ak::vec2
+// operation, is compared bit for bit with its C counterpart over pairs of
+// boundary values and random pairs spread across all bit lengths, as in
+// ak_math_check. Additions and lengths are only checked where the C side
+// does not overflow. A few results are also computed at compile time and
+// compared, so constant folding is covered too. Exits non-zero on any
+// difference.
+#include "ak_fixed.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef AK_MATH_32
+#define BACKEND "32-bit"
+#else
+#define BACKEND "64-bit"
+#endif
+
+#define MAX_EDGES 512
+
+static ak_fixed_t edges[MAX_EDGES];
+static int edge_count;
+
+static void AddEdge(int64_t v) {
+  if (v >= INT32_MIN && v <= INT32_MAX && edge_count < MAX_EDGES)
+    edges[edge_count++] = (ak_fixed_t)v;
+}
+
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t Random(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (uint32_t)(rng >> 32);
+}
+
+// A value with a random bit length from 0 to 32 and a random sign
+static ak_fixed_t RandomValue(void) {
+  uint32_t bits = Random() % 33;
+  uint32_t v = bits == 32 ? Random() : Random() & ((1u << bits) - 1);
+  return (ak_fixed_t)(Random() & 1 ? 0u - v : v);
+}
+
+static long failures;
+
+static int Same(const char *op, ak_fixed_t a, ak_fixed_t b, ak_fixed_t cpp,
+                ak_fixed_t c) {
+  if (cpp == c)
+    return 1;
+  printf("%s(%ld, %ld): ak::fixed %ld, C %ld\n", op, (long)a, (long)b,
+         (long)cpp, (long)c);
+  failures++;
+  return 0;
+}
+
+static int Fits(int64_t v) { return v >= INT32_MIN && v <= INT32_MAX; }
+
+// --- ak::fixed ---
+
+static void CheckFixed(ak_fixed_t a, ak_fixed_t b) {
+  ak::fixed fa = ak::fixed::from_raw(a), fb = ak::fixed::from_raw(b);
+  if (Fits((int64_t)a + b))
+    Same("add", a, b, (fa + fb).raw, AK_FIXED_ADD(a, b));
+  if (Fits((int64_t)a - b))
+    Same("sub", a, b, (fa - fb).raw, AK_FIXED_SUB(a, b));
+  Same("mul", a, b, (fa * fb).raw, AK_FIXED_MUL(a, b));
+  if (b != 0)
+    Same("div", a, b, (fa / fb).raw, AK_FIXED_DIV(a, b));
+  Same("min", a, b, ak::min(fa, fb).raw, AK_FIXED_MIN(a, b));
+  Same("max", a, b, ak::max(fa, fb).raw, AK_FIXED_MAX(a, b));
+  Same("to_int", a, 0, fa.to_int(), AK_FIXED_TO_INT(a));
+  Same("sqrt", a, 0, ak::sqrt(fa).raw, AK_FIXED_SQRT(a));
+  if (a != INT32_MIN)
+    Same("abs", a, 0, ak::abs(fa).raw, AK_FIXED_ABS(a));
+  if (a >= -32768 && a <= 32767)
+    Same("from_int", a, 0, ak::fixed((int)a).raw, AK_INT_TO_FIXED(a));
+}
+
+// --- ak::vec2 ---
+
+static void CheckVec2(ak_vec2_t u, ak_vec2_t v, ak_fixed_t s) {
+  ak::vec2 cu = u, cv = v;
+  ak::fixed cs = ak::fixed::from_raw(s);
+  if (Fits((int64_t)u.x + v.x) && Fits((int64_t)u.y + v.y)) {
+    ak_vec2_t sum = ak_vec2_add(u, v);
+    ak_vec2_t got = cu + cv;
+    Same("vec2 add.x", u.x, v.x, got.x, sum.x);
+    Same("vec2 add.y", u.y, v.y, got.y, sum.y);
+  }
+  if (Fits((int64_t)u.x - v.x) && Fits((int64_t)u.y - v.y)) {
+    ak_vec2_t diff = ak_vec2_sub(u, v);
+    ak_vec2_t got = cu - cv;
+    Same("vec2 sub.x", u.x, v.x, got.x, diff.x);
+    Same("vec2 sub.y", u.y, v.y, got.y, diff.y);
+  }
+  ak_vec2_t scaled = ak_vec2_mul(u, s);
+  ak_vec2_t got = cu * cs;
+  Same("vec2 mul.x", u.x, s, got.x, scaled.x);
+  Same("vec2 mul.y", u.y, s, got.y, scaled.y);
+  if (Fits((int64_t)AK_FIXED_MUL(u.x, v.x) + AK_FIXED_MUL(u.y, v.y)))
+    Same("dot", u.x, v.x, ak::dot(cu, cv).raw, ak_vec2_dot(u, v));
+  if (Fits((int64_t)AK_FIXED_MUL(u.x, u.x) + AK_FIXED_MUL(u.y, u.y)) ||
+      u.x > 8000000 || u.x < -8000000 || u.y > 8000000 || u.y < -8000000)
+    Same("len_sqr", u.x, u.y, ak::len_sqr(cu).raw, ak_vec2_len_sqr(u));
+  // The C sum of squares overflows int64 only with both components at -2^31
+  if (u.x != INT32_MIN || u.y != INT32_MIN)
+    Same("len", u.x, u.y, ak::len(cu).raw, ak_vec2_len(u));
+}
+
+// --- Constant folding ---
+
+constexpr ak::fixed kDt = ak::fixed(1) / 60;
+constexpr ak::fixed kBounce = ak::fixed::from_float(0.7);
+constexpr ak::fixed kScaled = ak::fixed(-320) * kBounce / kDt;
+constexpr ak::fixed kRoot = ak::sqrt(ak::fixed(2));
+constexpr ak::fixed kLen = ak::len(ak::vec2(ak::fixed(3), ak::fixed(-4)));
+
+static void CheckConstants(void) {
+  ak_fixed_t dt = AK_FIXED_DIV(AK_INT_TO_FIXED(1), AK_INT_TO_FIXED(60));
+  ak_fixed_t bounce = AK_FLOAT_TO_FIXED(0.7);
+  ak_fixed_t scaled =
+      AK_FIXED_DIV(AK_FIXED_MUL(-AK_INT_TO_FIXED(320), bounce), dt);
+  ak_vec2_t v = {AK_INT_TO_FIXED(3), AK_INT_TO_FIXED(-4)};
+  Same("constexpr dt", 1, 60, kDt.raw, dt);
+  Same("constexpr bounce", 0, 0, kBounce.raw, bounce);
+  Same("constexpr scaled", -320, 0, kScaled.raw, scaled);
+  Same("constexpr sqrt", 2, 0, kRoot.raw, AK_FIXED_SQRT(AK_INT_TO_FIXED(2)));
+  Same("constexpr len", 3, -4, kLen.raw, ak_vec2_len(v));
+}
+
+int main(int argc, char **argv) {
+  long pairs = 10000000;
+  if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+    pairs = atol(argv[2]);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-n random_pairs]\n", argv[0]);
+    return 2;
+  }
+
+  for (int s = 0; s < 32; s++) {
+    int64_t p = (int64_t)1 << s;
+    for (int64_t d = -1; d <= 1; d++) {
+      AddEdge(p + d);
+      AddEdge(-p + d);
+    }
+  }
+  AddEdge(INT32_MIN);
+  AddEdge(INT32_MAX);
+  AddEdge(AK_INT_TO_FIXED(1) / 60);
+  AddEdge(AK_FLOAT_TO_FIXED(0.7));
+  AddEdge(AK_FLOAT_TO_FIXED(-0.5));
+  AddEdge(AK_INT_TO_FIXED(320));
+  AddEdge(-AK_INT_TO_FIXED(240));
+
+  CheckConstants();
+  long checked = 0;
+  for (int i = 0; i < edge_count; i++) {
+    for (int j = 0; j < edge_count; j++) {
+      CheckFixed(edges[i], edges[j]);
+      ak_vec2_t u = {edges[i], edges[j]}, v = {edges[j], edges[i]};
+      CheckVec2(u, v, edges[(i + j) % edge_count]);
+      checked++;
+    }
+  }
+  for (long n = 0; n < pairs && failures < 10; n++) {
+    CheckFixed(RandomValue(), RandomValue());
+    ak_vec2_t u = {RandomValue(), RandomValue()};
+    ak_vec2_t v = {RandomValue(), RandomValue()};
+    CheckVec2(u, v, RandomValue());
+    checked++;
+  }
+  printf("%s backend: %ld pairs checked, %ld mismatches\n", BACKEND, checked,
+         failures);
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+// Checks the 32-bit math backend (-DAK_MATH_32) against the 64-bit macros.
+//
+//   ak_math_check [-n random_pairs]
+//
+// Compares ak_fixed_mul32 and ak_fixed_div32 with AK_FIXED_MUL_64 and
+// AK_FIXED_DIV_64 over every pair of boundary values (powers of two, their
+// neighbours and the 16.16 constants the engine uses), then over random pairs
+// whose magnitudes are spread evenly across all bit lengths, so small values
+// (restitution, dt, friction) are covered as densely as huge world
+// coordinates. Exits non-zero if any result differs.
+#include "ak_fixed.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_EDGES 512
+
+static ak_fixed_t edges[MAX_EDGES];
+static int edge_count;
+
+static void AddEdge(int64_t v) {
+  if (v >= INT32_MIN && v <= INT32_MAX && edge_count < MAX_EDGES)
+    edges[edge_count++] = (ak_fixed_t)v;
+}
+
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t Random(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (uint32_t)(rng >> 32);
+}
+
+// A value with a random bit length from 0 to 32 and a random sign
+static ak_fixed_t RandomValue(void) {
+  uint32_t bits = Random() % 33;
+  uint32_t v = bits == 32 ? Random() : Random() & ((1u << bits) - 1);
+  return (ak_fixed_t)(Random() & 1 ? 0u - v : v);
+}
+
+static long failures;
+
+static int Check(ak_fixed_t a, ak_fixed_t b) {
+  ak_fixed_t m64 = AK_FIXED_MUL_64(a, b), m32 = ak_fixed_mul32(a, b);
+  if (m64 != m32) {
+    printf("mul(%ld, %ld): 64-bit %ld, 32-bit %ld\n", (long)a, (long)b,
+           (long)m64, (long)m32);
+    return 0;
+  }
+  if (b == 0)
+    return 1;
+  ak_fixed_t d64 = AK_FIXED_DIV_64(a, b), d32 = ak_fixed_div32(a, b);
+  if (d64 != d32) {
+    printf("div(%ld, %ld): 64-bit %ld, 32-bit %ld\n", (long)a, (long)b,
+           (long)d64, (long)d32);
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv) {
+  long pairs = 100000000;
+  if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+    pairs = atol(argv[2]);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-n random_pairs]\n", argv[0]);
+    return 2;
+  }
+
+  for (int s = 0; s < 32; s++) {
+    int64_t p = (int64_t)1 << s;
+    for (int64_t d = -1; d <= 1; d++) {
+      AddEdge(p + d);
+      AddEdge(-p + d);
+    }
+  }
+  AddEdge(INT32_MIN);
+  AddEdge(INT32_MAX);
+  AddEdge(AK_INT_TO_FIXED(1) / 60);
+  AddEdge(AK_FLOAT_TO_FIXED(0.7));
+  AddEdge(AK_FLOAT_TO_FIXED(-0.5));
+  AddEdge(AK_INT_TO_FIXED(320));
+  AddEdge(-AK_INT_TO_FIXED(240));
+
+  long checked = 0;
+  for (int i = 0; i < edge_count; i++) {
+    for (int j = 0; j < edge_count; j++) {
+      failures += !Check(edges[i], edges[j]);
+      checked++;
+    }
+  }
+  for (long n = 0; n < pairs && failures < 10; n++) {
+    failures += !Check(RandomValue(), RandomValue());
+    checked++;
+  }
+  printf("%ld pairs checked, %ld mismatches\n", checked, failures);
+
+  return failures ? 1 : 0;
+}
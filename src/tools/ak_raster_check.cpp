@@ -0,0 +1,221 @@
+// Checks the Lynx 4bpp rasterizer (src/platforms/lynx/lynx_raster.cpp)
+// against a plain one-byte-per-pixel reference on the host.
+//
+//   ak_raster_check [-n random_ops]
+//
+// Random clears, plots, spans, rects and circles (including odd-nibble edges,
+// shapes clipped by every side and radii past the span tables) are drawn
+// into packed surfaces of several sizes, some with odd widths and row
+// padding, and into the reference. After every operation the unpacked
+// surface must match the reference, and the row padding and the guard bytes
+// around the buffer must be untouched. Exits non-zero on any difference.
+#include "lynx_raster.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define GUARD 16
+#define GUARD_BYTE 0xA5
+
+struct surface_case_t {
+  int width, height, stride;
+};
+
+static const surface_case_t cases[] = {
+    {160, 102, 80}, // The Lynx frame
+    {37, 11, 20},   // Odd width, padded rows
+    {8, 5, 4},
+    {1, 1, 1},
+};
+
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t Random(void) {
+  rng ^= rng << 13;
+  rng ^= rng >> 7;
+  rng ^= rng << 17;
+  return (uint32_t)(rng >> 32);
+}
+
+// Uniform in [lo, hi]
+static int RandomRange(int lo, int hi) {
+  return lo + (int)(Random() % (uint32_t)(hi - lo + 1));
+}
+
+// --- Reference: one byte per pixel, every write clipped per pixel ---
+
+static uint8_t ref[102][160];
+
+static void RefPlot(const surface_case_t &c, int x, int y, uint8_t color) {
+  if (x >= 0 && y >= 0 && x < c.width && y < c.height)
+    ref[y][x] = color & 0x0F;
+}
+
+static void RefClear(const surface_case_t &c, uint8_t color) {
+  for (int y = 0; y < c.height; y++)
+    for (int x = 0; x < c.width; x++)
+      ref[y][x] = color & 0x0F;
+}
+
+static void RefSpan(const surface_case_t &c, int x0, int x1, int y,
+                    uint8_t color) {
+  for (int x = x0; x <= x1; x++)
+    RefPlot(c, x, y, color);
+}
+
+static void RefRect(const surface_case_t &c, int x, int y, int w, int h,
+                    uint8_t color) {
+  for (int py = y; py < y + h; py++)
+    RefSpan(c, x, x + w - 1, py, color);
+}
+
+static void RefCircle(const surface_case_t &c, int x, int y, int r,
+                      uint8_t color) {
+  for (int dy = -r; dy <= r; dy++)
+    for (int dx = -r; dx <= r; dx++)
+      if (dx * dx + dy * dy <= r * r)
+        RefPlot(c, x + dx, y + dy, color);
+}
+
+// --- Comparison ---
+
+static uint8_t memory[GUARD + 80 * 102 + GUARD];
+static uint8_t cleared[80 * 102]; // The buffer as the last clear left it
+
+static int Pixel(const lynx_surface_t &s, int x, int y) {
+  uint8_t b = s.pixels[y * s.stride + (x >> 1)];
+  return (x & 1) ? (b & 0x0F) : (b >> 4);
+}
+
+static long failures;
+
+static int Compare(const lynx_surface_t &s, const surface_case_t &c,
+                   const char *op) {
+  for (int y = 0; y < c.height; y++) {
+    for (int x = 0; x < c.width; x++) {
+      if (Pixel(s, x, y) != ref[y][x]) {
+        printf("%dx%d after %s: pixel %d,%d is %d, expected %d\n", c.width,
+               c.height, op, x, y, Pixel(s, x, y), ref[y][x]);
+        return 0;
+      }
+    }
+    // An odd width leaves a spare low nibble in the last byte; it counts as
+    // padding, which only clears may write
+    if (c.width & 1) {
+      uint8_t b = s.pixels[y * s.stride + c.width / 2];
+      uint8_t was = cleared[y * s.stride + c.width / 2];
+      if ((b & 0x0F) != (was & 0x0F)) {
+        printf("%dx%d after %s: spare nibble of row %d written\n", c.width,
+               c.height, op, y);
+        return 0;
+      }
+    }
+    for (int i = (c.width + 1) / 2; i < c.stride; i++) {
+      if (s.pixels[y * s.stride + i] != cleared[y * s.stride + i]) {
+        printf("%dx%d after %s: padding of row %d written\n", c.width,
+               c.height, op, y);
+        return 0;
+      }
+    }
+  }
+  int size = c.stride * c.height;
+  for (int i = 0; i < GUARD; i++) {
+    if (memory[i] != GUARD_BYTE || memory[GUARD + size + i] != GUARD_BYTE) {
+      printf("%dx%d after %s: wrote outside the buffer\n", c.width, c.height,
+             op);
+      return 0;
+    }
+  }
+  return 1;
+}
+
+// Clears fill the padding too; remember what they left there
+static void Clear(const lynx_surface_t &s, const surface_case_t &c,
+                  uint8_t color) {
+  lynx_raster_clear(&s, color);
+  RefClear(c, color);
+  memcpy(cleared, s.pixels, (size_t)(c.stride * c.height));
+}
+
+static long RunCase(const surface_case_t &c, long ops) {
+  memset(memory, GUARD_BYTE, sizeof(memory));
+  lynx_surface_t s = {memory + GUARD, c.width, c.height, c.stride};
+  Clear(s, c, 0);
+  if (!Compare(s, c, "clear")) {
+    failures++;
+    return 1;
+  }
+
+  // Coordinates reach a little past every edge so clipping is exercised
+  int mx = c.width / 4 + 4, my = c.height / 4 + 4;
+  long done = 0;
+  for (long n = 0; n < ops && failures < 10; n++, done++) {
+    uint8_t color = static_cast<uint8_t>(Random() & 0x0F);
+    int x = RandomRange(-mx, c.width - 1 + mx);
+    int y = RandomRange(-my, c.height - 1 + my);
+    const char *op;
+    switch (Random() % 16) {
+    case 0:
+      op = "clear";
+      Clear(s, c, color);
+      break;
+    case 1:
+    case 2:
+      op = "plot";
+      lynx_raster_plot(&s, x, y, color);
+      RefPlot(c, x, y, color);
+      break;
+    case 3:
+    case 4:
+    case 5:
+    case 6: {
+      op = "span";
+      int x1 = RandomRange(-mx, c.width - 1 + mx);
+      lynx_raster_span(&s, x, x1, y, color);
+      RefSpan(c, x, x1, y, color);
+      break;
+    }
+    case 7:
+    case 8:
+    case 9:
+    case 10: {
+      op = "rect";
+      int w = RandomRange(-2, c.width + 2 * mx);
+      int h = RandomRange(-2, c.height + 2 * my);
+      lynx_raster_rect(&s, x, y, w, h, color);
+      RefRect(c, x, y, w, h, color);
+      break;
+    }
+    default: {
+      op = "circle";
+      // Mostly table radii, sometimes past LYNX_RASTER_MAX_RADIUS
+      int r = Random() % 8 ? RandomRange(-1, 12)
+                           : RandomRange(0, LYNX_RASTER_MAX_RADIUS + 16);
+      lynx_raster_circle(&s, x, y, r, color);
+      if (r >= 0)
+        RefCircle(c, x, y, r, color);
+      break;
+    }
+    }
+    if (!Compare(s, c, op))
+      failures++;
+  }
+  return done;
+}
+
+int main(int argc, char **argv) {
+  long ops = 200000;
+  if (argc == 3 && strcmp(argv[1], "-n") == 0) {
+    ops = atol(argv[2]);
+  } else if (argc != 1) {
+    fprintf(stderr, "usage: %s [-n random_ops]\n", argv[0]);
+    return 2;
+  }
+
+  long checked = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    checked += RunCase(cases[i], ops);
+  printf("%ld operations checked, %ld mismatches\n", checked, failures);
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,308 @@
+// Stress scene generator: writes a parameterized .aks scene.
+//
+//   ak_scene_gen -o stress.aks -n 5000 -t 200 -w 1280 -h 960 -c 70 -s 1
+//
+// Bodies are laid out on a jittered grid above a static floor, with the
+// given percentage of circles (the rest are boxes). Tethers link
+// neighbouring bodies in the same grid row.
+//
+// With -g sector_px it writes a streaming level (.akl, see ak_sectors.h)
+// instead: the same layout over a width x height level, cut into sectors,
+// with the floor split at sector edges. Tethers are not streamed.
+//
+//   ak_scene_gen -o long.akl -g 256 -n 3000 -w 32768 -h 256
+#include "ak_scene.h"
+#include "ak_sectors.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t rng_state;
+
+static uint32_t NextRandom(void) {
+  // xorshift32: same stream on every host for a given seed
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+// Uniform in [lo, hi] pixels, as 16.16
+static ak_fixed_t RandomRange(int lo, int hi) {
+  uint32_t span = (uint32_t)(hi - lo) << AK_FIXED_SHIFT;
+  return AK_INT_TO_FIXED(lo) + (ak_fixed_t)(NextRandom() % (span + 1));
+}
+
+// Body i of the jittered grid above the floor. *x, *y get the centre of its
+// cell in pixels and b->position the jitter from there, so the caller can
+// place it in a level wider than 16.16 reaches.
+static void GridBody(ak_scene_body_t *b, long *x, long *y, long i, long cols,
+                     long cell, long top, long circle_pct, long max_radius) {
+  long col = i % cols;
+  long row = i / cols;
+  int is_circle = (long)(NextRandom() % 100) < circle_pct;
+  ak_fixed_t extent = RandomRange(1, (int)max_radius);
+  ak_fixed_t slack = AK_INT_TO_FIXED(max_radius) - extent;
+
+  memset(b, 0, sizeof(*b));
+  *x = 1 + col * cell + cell / 2;
+  *y = top - row * cell - cell / 2;
+  if (slack > 0) {
+    b->position.x += (ak_fixed_t)(NextRandom() % (uint32_t)slack) - slack / 2;
+  }
+  b->velocity.x = RandomRange(-20, 20);
+  b->velocity.y = RandomRange(-20, 0);
+  b->mass = RandomRange(1, 5);
+  b->restitution = AK_FLOAT_TO_FIXED(0.7);
+  b->shape_type = is_circle ? AK_SHAPE_CIRCLE : AK_SHAPE_AABB;
+  b->extent_x = extent;
+  b->extent_y = is_circle ? 0 : extent;
+}
+
+typedef struct {
+  long x, y;            // Level pixels; body.position is the offset from here
+  ak_scene_body_t body;
+} level_body_t;
+
+static int WriteLevel(const char *out_path, long bodies, long width,
+                      long height, long circle_pct, long max_radius,
+                      long size) {
+  long cell = max_radius * 2 + 2;
+  long cols = (width - 2) / cell;
+  long floor_h = 10;
+  long sector_cols = (width + size - 1) / size;
+  long sector_rows = (height + size - 1) / size;
+  long sectors = sector_cols * sector_rows;
+  long total = bodies + sector_cols;
+  if (sectors > AK_MAX_SECTORS) {
+    fprintf(stderr, "%ld sectors, at most %d; use larger sectors\n", sectors,
+            AK_MAX_SECTORS);
+    return 1;
+  }
+  level_body_t *all = (level_body_t *)malloc(total * sizeof(level_body_t));
+  long *count = (long *)calloc(sectors, sizeof(long));
+  if (!all || !count) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  // One floor piece per sector column, in the sector holding its centre
+  for (long c = 0; c < sector_cols; c++) {
+    long x0 = c * size;
+    long x1 = x0 + size < width ? x0 + size : width;
+    level_body_t *l = &all[c];
+    memset(&l->body, 0, sizeof(l->body));
+    l->x = x0;
+    l->y = height - floor_h;
+    l->body.position.x = AK_INT_TO_FIXED(x1 - x0) / 2;
+    l->body.restitution = AK_FLOAT_TO_FIXED(0.7);
+    l->body.shape_type = AK_SHAPE_AABB;
+    l->body.extent_x = AK_INT_TO_FIXED(x1 - x0) / 2;
+    l->body.extent_y = AK_INT_TO_FIXED(floor_h);
+  }
+  for (long i = 0; i < bodies; i++) {
+    level_body_t *l = &all[sector_cols + i];
+    GridBody(&l->body, &l->x, &l->y, i, cols, cell, height - floor_h * 2,
+             circle_pct, max_radius);
+  }
+
+  // Bucket by sector
+  long *sector_of = (long *)malloc(total * sizeof(long));
+  if (!sector_of) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+  for (long i = 0; i < total; i++) {
+    long c = all[i].x / size, r = all[i].y / size;
+    sector_of[i] = r * sector_cols + c;
+    if (++count[sector_of[i]] > AK_MAX_SECTOR_BODIES) {
+      fprintf(stderr,
+              "sector %ld holds more than %d bodies; use smaller sectors or "
+              "fewer bodies\n",
+              sector_of[i], AK_MAX_SECTOR_BODIES);
+      return 1;
+    }
+  }
+
+  FILE *f = fopen(out_path, "wb");
+  if (!f) {
+    perror(out_path);
+    return 1;
+  }
+  ak_sector_header_t h;
+  h.magic = AK_SECTOR_MAGIC;
+  h.version = AK_SECTOR_VERSION;
+  h.sector_size = (int32_t)size;
+  h.cols = (int32_t)sector_cols;
+  h.rows = (int32_t)sector_rows;
+  h.origin_x = 0;
+  h.origin_y = 0;
+  uint8_t rec[AK_SECTOR_HEADER_SIZE + AK_SCENE_BODY_SIZE];
+  ak_sector_encode_header(rec, &h);
+  fwrite(rec, 1, AK_SECTOR_HEADER_SIZE, f);
+
+  uint32_t offset =
+      AK_SECTOR_HEADER_SIZE + (uint32_t)sectors * AK_SECTOR_ENTRY_SIZE;
+  for (long s = 0; s < sectors; s++) {
+    ak_sector_entry_t e = {offset, (uint32_t)count[s]};
+    ak_sector_encode_entry(rec, &e);
+    fwrite(rec, 1, AK_SECTOR_ENTRY_SIZE, f);
+    offset += (uint32_t)count[s] * AK_SCENE_BODY_SIZE;
+  }
+  for (long s = 0; s < sectors; s++) {
+    long x0 = (s % sector_cols) * size, y0 = (s / sector_cols) * size;
+    for (long i = 0; i < total; i++) {
+      if (sector_of[i] != s)
+        continue;
+      ak_scene_body_t b = all[i].body;
+      b.position.x += AK_INT_TO_FIXED(all[i].x - x0);
+      b.position.y += AK_INT_TO_FIXED(all[i].y - y0);
+      ak_scene_encode_body(rec, &b);
+      fwrite(rec, 1, AK_SCENE_BODY_SIZE, f);
+    }
+  }
+
+  free(sector_of);
+  free(count);
+  free(all);
+  if (fclose(f) != 0) {
+    perror(out_path);
+    return 1;
+  }
+  printf("%s: %ld bodies in %ldx%ld sectors of %ld px, %ldx%ld\n", out_path,
+         total, sector_cols, sector_rows, size, width, height);
+  return 0;
+}
+
+static void Usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s -o out.aks [-n bodies] [-t tethers] [-w width] "
+          "[-h height] [-c circle_percent] [-r max_radius] [-s seed] "
+          "[-g sector_px]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  const char *out_path = NULL;
+  // The defaults fill about three quarters of the 320x240 demo world
+  long bodies = 500, tethers = 0, width = 320, height = 240;
+  long circle_pct = 70, max_radius = 4, seed = 1, sector = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 'o': out_path = v; break;
+    case 'n': bodies = atol(v); break;
+    case 't': tethers = atol(v); break;
+    case 'w': width = atol(v); break;
+    case 'h': height = atol(v); break;
+    case 'c': circle_pct = atol(v); break;
+    case 'r': max_radius = atol(v); break;
+    case 's': seed = atol(v); break;
+    case 'g': sector = atol(v); break;
+    default: Usage(argv[0]); return 2;
+    }
+  }
+  if (!out_path || bodies < 0 || tethers < 0 || width <= 0 || height <= 0 ||
+      max_radius < 1 || sector < 0) {
+    Usage(argv[0]);
+    return 2;
+  }
+  rng_state = seed ? (uint32_t)seed : 1;
+
+  // Grid cells are sized to fit the largest body with a 1px gap
+  long cell = max_radius * 2 + 2;
+  long cols = (width - 2) / cell;
+  long floor_h = 10;
+  long rows_avail = (height - floor_h * 2) / cell;
+  if (cols < 1 || rows_avail * cols < bodies) {
+    fprintf(stderr, "%ld bodies do not fit in %ldx%ld; enlarge the world\n",
+            bodies, width, height);
+    return 1;
+  }
+  if (tethers > bodies) {
+    tethers = bodies;
+  }
+  if (sector)
+    return WriteLevel(out_path, bodies, width, height, circle_pct, max_radius,
+                      sector);
+
+  FILE *f = fopen(out_path, "wb");
+  if (!f) {
+    perror(out_path);
+    return 1;
+  }
+
+  // Gravity scaled like the demo scene (50 px/s^2 at 240px tall)
+  ak_scene_header_t h;
+  h.magic = AK_SCENE_MAGIC;
+  h.version = AK_SCENE_VERSION;
+  h.width = AK_INT_TO_FIXED(width);
+  h.height = AK_INT_TO_FIXED(height);
+  h.gravity.x = 0;
+  h.gravity.y = AK_FIXED_MUL(AK_INT_TO_FIXED(50),
+                             AK_FIXED_DIV(h.height, AK_INT_TO_FIXED(240)));
+  h.body_count = (uint32_t)bodies + 1; // + floor
+  h.tether_count = (uint32_t)tethers;
+  h.rope_count = 0;
+
+  uint8_t rec[AK_SCENE_HEADER_SIZE];
+  ak_scene_encode_header(rec, &h);
+  fwrite(rec, 1, AK_SCENE_HEADER_SIZE, f);
+
+  // Floor
+  ak_scene_body_t b;
+  memset(&b, 0, sizeof(b));
+  b.position.x = AK_INT_TO_FIXED(width) / 2;
+  b.position.y = AK_INT_TO_FIXED(height - floor_h);
+  b.restitution = AK_FLOAT_TO_FIXED(0.7);
+  b.shape_type = AK_SHAPE_AABB;
+  b.extent_x = AK_INT_TO_FIXED(width) / 2;
+  b.extent_y = AK_INT_TO_FIXED(floor_h);
+  ak_scene_encode_body(rec, &b);
+  fwrite(rec, 1, AK_SCENE_BODY_SIZE, f);
+
+  // Fill from the floor upwards so dense scenes start as piles
+  long top = height - floor_h * 2;
+  for (long i = 0; i < bodies; i++) {
+    long x, y;
+    GridBody(&b, &x, &y, i, cols, cell, top, circle_pct, max_radius);
+    b.position.x += AK_INT_TO_FIXED(x);
+    b.position.y += AK_INT_TO_FIXED(y);
+    ak_scene_encode_body(rec, &b);
+    fwrite(rec, 1, AK_SCENE_BODY_SIZE, f);
+  }
+
+  // Link each tethered body to its left neighbour (body 0 is the floor)
+  ak_scene_tether_t t;
+  long linked = 0;
+  for (long i = 1; i < bodies && linked < tethers; i++) {
+    if (i % cols == 0)
+      continue;
+    t.a = (uint32_t)i;
+    t.b = (uint32_t)i + 1;
+    t.max_length = AK_INT_TO_FIXED(cell + cell / 2);
+    ak_scene_encode_tether(rec, &t);
+    fwrite(rec, 1, AK_SCENE_TETHER_SIZE, f);
+    linked++;
+  }
+  if (linked < tethers) {
+    // Not enough neighbours; patch the header with the real count
+    h.tether_count = (uint32_t)linked;
+    ak_scene_encode_header(rec, &h);
+    fseek(f, 0, SEEK_SET);
+    fwrite(rec, 1, AK_SCENE_HEADER_SIZE, f);
+  }
+
+  if (fclose(f) != 0) {
+    perror(out_path);
+    return 1;
+  }
+  printf("%s: %ld bodies, %ld tethers, %ldx%ld\n", out_path, bodies + 1,
+         linked, width, height);
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Viewer and inspector for a world mirrored into shared memory (pc_shm.h).
+//
+//   ak_shm_view [-n frames] [-i body_id] name
+//
+// Attaches read-only to the segment a simulation publishes (for example
+// `alpha_kinetics_pc -m name`) and draws it as ASCII about 30 times a
+// second. -i also prints the state of one body; -n stops after that many
+// frames (0, the default, runs until interrupted). The simulation is never
+// blocked: a frame overwritten mid-copy is simply read again.
+#include "pc_shm.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define VIEW_W 64
+#define VIEW_H 24
+
+static pc_shm_frame_t frame; // Large with the PC body limits
+
+static void Plot(char canvas[VIEW_H][VIEW_W + 1], int x, int y, char c,
+                 int overwrite) {
+  if (x < 0 || x >= VIEW_W || y < 0 || y >= VIEW_H)
+    return;
+  if (overwrite || canvas[y][x] == '.')
+    canvas[y][x] = c;
+}
+
+static void Draw(const pc_shm_frame_t *f) {
+  char canvas[VIEW_H][VIEW_W + 1];
+  for (int y = 0; y < VIEW_H; y++) {
+    memset(canvas[y], '.', VIEW_W);
+    canvas[y][VIEW_W] = '\0';
+  }
+
+  // World units per character
+  double sx = AK_FIXED_TO_FLOAT(f->width) / VIEW_W;
+  double sy = AK_FIXED_TO_FLOAT(f->height) / VIEW_H;
+  if (sx <= 0 || sy <= 0)
+    return;
+
+  for (int i = 0; i < f->body_count; i++) {
+    const ak_body_t *b = &f->bodies[i];
+    double px = AK_FIXED_TO_FLOAT(b->position.x);
+    double py = AK_FIXED_TO_FLOAT(b->position.y);
+    double ex, ey;
+    char c;
+    if (b->shape.type == AK_SHAPE_AABB) {
+      ex = AK_FIXED_TO_FLOAT(b->shape.bounds.aabb.width);
+      ey = AK_FIXED_TO_FLOAT(b->shape.bounds.aabb.height);
+      c = b->is_static ? '#' : '[';
+    } else {
+      ex = ey = AK_FIXED_TO_FLOAT(b->shape.bounds.circle.radius);
+      c = 'O';
+    }
+    int x0 = (int)((px - ex) / sx), x1 = (int)((px + ex) / sx);
+    int y0 = (int)((py - ey) / sy), y1 = (int)((py + ey) / sy);
+    for (int y = y0; y <= y1; y++) {
+      for (int x = x0; x <= x1; x++)
+        Plot(canvas, x, y, c, 1);
+    }
+  }
+
+  for (int i = 0; i < f->tether_count; i++) {
+    const ak_tether_t *t = &f->tethers[i];
+    if (t->a < 0 || t->b < 0 || t->a >= f->body_count ||
+        t->b >= f->body_count)
+      continue;
+    ak_vec2_t a = f->bodies[t->a].position, b = f->bodies[t->b].position;
+    for (int s = 1; s < 16; s++) {
+      double x = AK_FIXED_TO_FLOAT(a.x) +
+                 (AK_FIXED_TO_FLOAT(b.x) - AK_FIXED_TO_FLOAT(a.x)) * s / 16;
+      double y = AK_FIXED_TO_FLOAT(a.y) +
+                 (AK_FIXED_TO_FLOAT(b.y) - AK_FIXED_TO_FLOAT(a.y)) * s / 16;
+      Plot(canvas, (int)(x / sx), (int)(y / sy), '-', 0);
+    }
+  }
+
+  printf("\033[H\033[J");
+  for (int y = 0; y < VIEW_H; y++)
+    printf("%s\n", canvas[y]);
+}
+
+static void Inspect(const pc_shm_frame_t *f, int id) {
+  for (int i = 0; i < f->body_count; i++) {
+    const ak_body_t *b = &f->bodies[i];
+    if (b->id != id)
+      continue;
+    printf("body %d (index %d): pos %.2f, %.2f  vel %.2f, %.2f  mass %.2f%s\n",
+           id, i, AK_FIXED_TO_FLOAT(b->position.x),
+           AK_FIXED_TO_FLOAT(b->position.y), AK_FIXED_TO_FLOAT(b->velocity.x),
+           AK_FIXED_TO_FLOAT(b->velocity.y), AK_FIXED_TO_FLOAT(b->mass),
+           b->is_static ? "  static" : "");
+    return;
+  }
+  printf("body %d: not in world\n", id);
+}
+
+static void Usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-n frames] [-i body_id] name\n", prog);
+}
+
+int main(int argc, char **argv) {
+  long frames = 0;
+  int inspect = 0, inspect_id = 0;
+  const char *name = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-') {
+      name = argv[i];
+      continue;
+    }
+    if (i + 1 >= argc || strlen(argv[i]) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 'n': frames = atol(v); break;
+    case 'i': inspect = 1; inspect_id = atoi(v); break;
+    default: Usage(argv[0]); return 2;
+    }
+  }
+  if (!name || frames < 0) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  const pc_shm_t *shm = pc_shm_attach(name);
+  if (!shm)
+    return 1;
+
+  long shown = 0, retries = 0;
+  uint64_t last_step = 0;
+  while (frames == 0 || shown < frames) {
+    int r = pc_shm_read(shm, &frame);
+    if (r < 0) {
+      usleep(100000); // Nothing published yet
+      continue;
+    }
+    retries += r;
+    Draw(&frame);
+    printf("step %llu (+%llu)  bodies %d  tethers %d  origin %d, %d  "
+           "retries %ld\n",
+           (unsigned long long)frame.step,
+           (unsigned long long)(frame.step - last_step), frame.body_count,
+           frame.tether_count, (int)frame.origin_x, (int)frame.origin_y,
+           retries);
+    if (inspect)
+      Inspect(&frame, inspect_id);
+    fflush(stdout);
+    last_step = frame.step;
+    shown++;
+    usleep(33333);
+  }
+
+  pc_shm_detach(shm);
+  return 0;
+}
@@ -0,0 +1,189 @@
+// Benchmark for the specialized step variants (AK_STEP_VARIANTS).
+//
+//   ak_step_bench [-n bodies] [-s steps]
+//
+// For every variant, builds a scene that fits its feature subset, runs it
+// with ak_world_step and with the variant from the same start state, checks
+// the results are identical, and prints the time per step of each. Then does
+// the same for AK_PACK_LANES differently pushed copies of the generic scene,
+// stepped one by one and as a world pack.
+#define _POSIX_C_SOURCE 199309L
+#include "ak_physics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef void (*step_fn)(ak_world_t *world, ak_fixed_t dt);
+
+static ak_world_t start, generic, variant;
+static ak_world_t lanes[AK_PACK_LANES];
+static ak_world_pack_t pack;
+static uint32_t rng_state;
+
+static uint32_t NextRandom(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static double Now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+// A jittered grid of dynamic bodies falling into a box, optionally with a
+// static floor and static pegs, and tethers between horizontal neighbours.
+static void BuildScene(ak_world_t *w, long bodies, int shapes, int has_static,
+                       int has_tethers) {
+  const int cols = 32;
+  const int cell = 10;
+  long rows = (bodies + cols - 1) / cols;
+
+  ak_world_init(w, AK_INT_TO_FIXED(cols * cell + 40),
+                AK_INT_TO_FIXED((int)rows * cell + 80),
+                (ak_vec2_t){0, AK_INT_TO_FIXED(50)});
+  rng_state = 1;
+
+  if (has_static) {
+    ak_shape_t floor = {AK_SHAPE_AABB, {{0}}};
+    ak_shape_t peg = {AK_SHAPE_CIRCLE, {{0}}};
+    floor.bounds.aabb.width = w->width / 2;
+    floor.bounds.aabb.height = AK_INT_TO_FIXED(10);
+    peg.bounds.circle.radius = AK_INT_TO_FIXED(6);
+    if (shapes == AK_STEP_SHAPES_CIRCLE) {
+      // Circles-only worlds stand on a row of large static circles
+      floor.type = AK_SHAPE_CIRCLE;
+      floor.bounds.circle.radius = AK_INT_TO_FIXED(20);
+      for (int x = 20; x < cols * cell + 40; x += 40)
+        ak_world_add_body(w, floor, AK_INT_TO_FIXED(x), w->height, 0);
+    } else {
+      ak_world_add_body(w, floor, w->width / 2, w->height, 0);
+    }
+    if (shapes == AK_STEP_SHAPES_AABB) {
+      peg.type = AK_SHAPE_AABB;
+      peg.bounds.aabb.width = peg.bounds.aabb.height = AK_INT_TO_FIXED(4);
+    }
+    for (int x = 40; x < cols * cell; x += 60)
+      ak_world_add_body(w, peg, AK_INT_TO_FIXED(x), w->height / 2, 0);
+  }
+
+  int first = w->body_count;
+  for (long i = 0; i < bodies && w->body_count < AK_MAX_BODIES; i++) {
+    ak_shape_t s;
+    int circle = shapes == AK_STEP_SHAPES_CIRCLE ||
+                 (shapes == AK_STEP_SHAPES_ANY && (NextRandom() & 1));
+    ak_fixed_t extent = AK_INT_TO_FIXED(2) + (ak_fixed_t)(NextRandom() % 0x20000);
+    s.type = circle ? AK_SHAPE_CIRCLE : AK_SHAPE_AABB;
+    if (circle) {
+      s.bounds.circle.radius = extent;
+    } else {
+      s.bounds.aabb.width = extent;
+      s.bounds.aabb.height = extent;
+    }
+    ak_body_t *b = ak_world_add_body(
+        w, s, AK_INT_TO_FIXED(20 + (int)(i % cols) * cell + cell / 2),
+        AK_INT_TO_FIXED(20 + (int)(i / cols) * cell), AK_INT_TO_FIXED(1));
+    b->velocity.x = (ak_fixed_t)(NextRandom() % 0x140000) - 0xA0000;
+  }
+
+  if (has_tethers) {
+    for (int i = first; i + 1 < w->body_count; i += 2) {
+      if ((i - first) % cols == cols - 1)
+        continue;
+      ak_world_add_tether(w, &w->bodies[i], &w->bodies[i + 1],
+                          AK_INT_TO_FIXED(cell + cell / 2));
+    }
+  }
+}
+
+static double Run(ak_world_t *w, step_fn step, long steps, ak_fixed_t dt) {
+  double t0 = Now();
+  for (long s = 0; s < steps; s++)
+    step(w, dt);
+  return (Now() - t0) / (double)steps;
+}
+
+int main(int argc, char **argv) {
+  long bodies = 400, steps = 300;
+
+  for (int i = 1; i < argc; i++) {
+    if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2) {
+      fprintf(stderr, "usage: %s [-n bodies] [-s steps]\n", argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 'n': bodies = atol(v); break;
+    case 's': steps = atol(v); break;
+    default:
+      fprintf(stderr, "usage: %s [-n bodies] [-s steps]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (bodies < 1 || steps < 1) {
+    fprintf(stderr, "bodies and steps must be positive\n");
+    return 2;
+  }
+
+  ak_fixed_t dt = AK_FIXED_DIV(AK_FIXED_ONE, AK_INT_TO_FIXED(60));
+  int failed = 0;
+
+  printf("%-20s %8s %12s %12s %8s\n", "variant", "bodies", "generic us",
+         "variant us", "speedup");
+
+#define AK_BENCH_VARIANT(name, shapes, has_static, has_tethers)               \
+  {                                                                           \
+    BuildScene(&start, bodies, shapes, has_static, has_tethers);              \
+    generic = start;                                                          \
+    variant = start;                                                          \
+    double tg = Run(&generic, ak_world_step, steps, dt);                      \
+    double tv = Run(&variant, ak_world_step_##name, steps, dt);               \
+    int same = memcmp(generic.bodies, variant.bodies,                         \
+                      sizeof(ak_body_t) * (size_t)start.body_count) == 0;     \
+    printf("%-20s %8d %12.1f %12.1f %7.2fx%s\n", #name, start.body_count,     \
+           tg * 1e6, tv * 1e6, tg / tv, same ? "" : "  MISMATCH");            \
+    failed |= !same;                                                          \
+  }
+  AK_STEP_VARIANTS(AK_BENCH_VARIANT)
+
+  // World pack: times are for all lanes' worlds together
+  const ak_world_t *worlds[AK_PACK_LANES];
+  BuildScene(&start, bodies, AK_STEP_SHAPES_ANY, 1, 1);
+  for (int l = 0; l < AK_PACK_LANES; l++) {
+    lanes[l] = start;
+    for (int i = 0; i < start.body_count; i++)
+      lanes[l].bodies[i].velocity.x += (ak_fixed_t)l * 0x4000;
+    worlds[l] = &lanes[l];
+  }
+  if (!ak_world_pack_load(&pack, worlds, AK_PACK_LANES)) {
+    fprintf(stderr, "pack rejected the scene\n");
+    return 1;
+  }
+  double t0 = Now();
+  for (long s = 0; s < steps; s++) {
+    for (int l = 0; l < AK_PACK_LANES; l++)
+      ak_world_step(&lanes[l], dt);
+  }
+  double tg = (Now() - t0) / (double)steps;
+  t0 = Now();
+  for (long s = 0; s < steps; s++)
+    ak_world_pack_step(&pack, dt);
+  double tp = (Now() - t0) / (double)steps;
+  int same = 1;
+  for (int l = 0; l < AK_PACK_LANES; l++) {
+    variant = lanes[l];
+    ak_world_pack_store(&pack, l, &variant);
+    same &= memcmp(lanes[l].bodies, variant.bodies,
+                   sizeof(ak_body_t) * (size_t)start.body_count) == 0;
+  }
+  char name[32];
+  snprintf(name, sizeof(name), "pack x%d", AK_PACK_LANES);
+  printf("%-20s %8d %12.1f %12.1f %7.2fx%s\n", name, start.body_count,
+         tg * 1e6, tp * 1e6, tg / tp, same ? "" : "  MISMATCH");
+  failed |= !same;
+
+  return failed;
+}
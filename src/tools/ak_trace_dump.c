@@ -0,0 +1,90 @@
+// Reads body traces written by the PC demo (pc_trace.h).
+//
+//   ak_trace_dump [-s step] [-n steps] [-i body_id] trace.akt
+//
+// Without -s, prints a summary: chunks, step range and bytes per step. With
+// -s, seeks to that step and prints the bodies of -n consecutive steps
+// (default 1), or only the body with id -i.
+#include "pc_trace.h"
+#include <stdlib.h>
+#include <string.h>
+
+static pc_trace_body_t bodies[AK_MAX_BODIES];
+
+static void Usage(const char *prog) {
+  fprintf(stderr, "usage: %s [-s step] [-n steps] [-i body_id] trace.akt\n",
+          prog);
+}
+
+static void PrintBody(const pc_trace_body_t *b) {
+  printf("  body %d: pos %.3f, %.3f  vel %.3f, %.3f\n", (int)b->id,
+         AK_FIXED_TO_FLOAT(b->position.x), AK_FIXED_TO_FLOAT(b->position.y),
+         AK_FIXED_TO_FLOAT(b->velocity.x), AK_FIXED_TO_FLOAT(b->velocity.y));
+}
+
+int main(int argc, char **argv) {
+  long long first = -1;
+  long count = 1;
+  int filter = 0, filter_id = 0;
+  const char *path = NULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (argv[i][0] != '-') {
+      path = argv[i];
+      continue;
+    }
+    if (i + 1 >= argc || strlen(argv[i]) != 2) {
+      Usage(argv[0]);
+      return 2;
+    }
+    const char *v = argv[++i];
+    switch (argv[i - 1][1]) {
+    case 's': first = atoll(v); break;
+    case 'n': count = atol(v); break;
+    case 'i': filter = 1; filter_id = atoi(v); break;
+    default: Usage(argv[0]); return 2;
+    }
+  }
+  if (!path || count < 1) {
+    Usage(argv[0]);
+    return 2;
+  }
+
+  pc_trace_reader_t *r = pc_trace_reader_open(path);
+  if (!r)
+    return 1;
+
+  if (first < 0) {
+    uint64_t steps = 0, bytes = 0;
+    for (int c = 0; c < r->chunk_count; c++) {
+      steps += r->chunks[c].step_count;
+      bytes += r->chunks[c].payload_bytes;
+    }
+    printf("%s: %d chunks, %llu steps", path, r->chunk_count,
+           (unsigned long long)steps);
+    if (r->chunk_count) {
+      printf(" from step %llu, %.1f bytes/step",
+             (unsigned long long)r->chunks[0].first_step,
+             (double)bytes / (double)steps);
+    }
+    printf("\n");
+    pc_trace_reader_close(r);
+    return 0;
+  }
+
+  for (long n = 0; n < count; n++) {
+    uint64_t step = (uint64_t)first + (uint64_t)n;
+    int bodies_in_step = pc_trace_read_step(r, step, bodies, AK_MAX_BODIES);
+    if (bodies_in_step < 0) {
+      printf("step %llu: not in trace\n", (unsigned long long)step);
+      continue;
+    }
+    printf("step %llu: %d bodies\n", (unsigned long long)step, bodies_in_step);
+    for (int i = 0; i < bodies_in_step; i++) {
+      if (!filter || bodies[i].id == filter_id)
+        PrintBody(&bodies[i]);
+    }
+  }
+  pc_trace_reader_close(r);
+  return 0;
+}